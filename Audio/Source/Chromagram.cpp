@@ -0,0 +1,191 @@
+#include "Chromagram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Bins below the lowest guitar fundamental and above the useful partials are ignored
+    const double MIN_FUNDAMENTAL_HZ = 70.0;
+    const double MAX_BIN_HZ = 4000.0;
+
+    // A plucked note's upper partials, as pitch classes above it and their share of its chroma:
+    // octaves fold onto the note, then the 3rd, 5th and 7th harmonics
+    struct Partial { int interval; float weight; };
+    const Partial HARMONIC_PROFILE[] = { { 0, 1.0f }, { 7, 0.35f }, { 4, 0.2f }, { 10, 0.12f } };
+
+    // log (1 + k * amplitude) keeps one loud string from drowning the rest
+    const float COMPRESSION = 100.0f;
+
+    const double SMOOTHING_MS = 150.0;
+
+    // Matching
+    const float MIN_ENERGY = 0.5f;          // Below this the frame counts as silence
+    const float ACTIVE_FRACTION = 0.35f;    // A pitch class counts towards the chord above this share of the peak
+    const int MIN_ACTIVE_CLASSES = 3;       // A single note, or a note and its fifth, is not a chord
+    const float MIN_SCORE = 0.6f;
+    const float HYSTERESIS = 0.03f;         // A new chord has to beat the shown one by this much
+
+    // A single note's harmonics look much like a major triad, so a lone note or power chord
+    // only wins when it fits clearly better than every chord
+    const float NOT_CHORD_MARGIN = 0.05f;
+}
+
+Chromagram::Chromagram()
+{
+    // Expected chroma for every chord shape at every root, with each chord tone's harmonics
+    // spread in, centred so matching is a plain correlation. A lone note is a shape too, so a
+    // single note's own harmonics are not mistaken for a chord; it and the two-note shapes
+    // match as no chord.
+    for (int type = -1; type < ShowMe::NUM_CHORD_TYPES; ++type)
+    {
+        const unsigned intervals = type < 0 ? 1u : ShowMe::CHORD_TYPES[type].intervals;
+        int notes = 0;
+        for (unsigned m = intervals; m != 0; m &= m - 1)
+            ++notes;
+
+        for (int root = 0; root < 12; ++root)
+        {
+            Template t;
+            if (notes >= MIN_ACTIVE_CLASSES)
+                t.chord = { root, type, root };
+            t.mask = ShowMe::rotateMask (intervals, root);
+
+            for (int pc = 0; pc < 12; ++pc)
+                if (t.mask & (1u << pc))
+                    for (const auto& p : HARMONIC_PROFILE)
+                        t.profile[(pc + p.interval) % 12] += p.weight;
+
+            centre (t.profile);
+            templates.push_back (t);
+        }
+    }
+}
+
+void Chromagram::prepare (double sampleRate, int fftSize, double frameRateHz)
+{
+    binHz = (float) (sampleRate / fftSize);
+    firstBin = std::max (1, (int) (MIN_FUNDAMENTAL_HZ / binHz));
+    lastBin = std::min (fftSize / 2 - 2, (int) (MAX_BIN_HZ / binHz));
+
+    // Same scale as the spectrogram: a full-scale sine reads 1 through the Hann window
+    magnitudeScale = 4.0f / (float) fftSize;
+    smoothing = (float) std::exp (-1000.0 / (frameRateHz * SMOOTHING_MS));
+    reset();
+}
+
+void Chromagram::reset()
+{
+    std::fill (std::begin (smoothed), std::end (smoothed), 0.0f);
+    chord = {};
+    chordMask = 0;
+}
+
+void Chromagram::centre (float* values)
+{
+    float mean = 0.0f;
+    for (int pc = 0; pc < 12; ++pc)
+        mean += values[pc] / 12.0f;
+
+    float sumSquares = 0.0f;
+    for (int pc = 0; pc < 12; ++pc)
+    {
+        values[pc] -= mean;
+        sumSquares += values[pc] * values[pc];
+    }
+
+    const float norm = std::sqrt (sumSquares);
+    if (norm > 0.0f)
+        for (int pc = 0; pc < 12; ++pc)
+            values[pc] /= norm;
+}
+
+void Chromagram::process (const float* magnitudes)
+{
+    // Only spectral peaks count, so window leakage around loud partials does not smear energy
+    // into the neighbouring pitch classes. Low bins are wider than a semitone, so each peak's
+    // frequency is interpolated before it is given a pitch class.
+    float frame[12] {};
+    for (int bin = firstBin; bin <= lastBin; ++bin)
+    {
+        const float* m = magnitudes + bin;
+        if (! (m[0] > m[-1] && m[0] >= m[1]))
+            continue;
+
+        const float denom = m[-1] - 2.0f * m[0] + m[1];
+        const float offset = denom < 0.0f ? 0.5f * (m[-1] - m[1]) / denom : 0.0f;
+        const float hz = (bin + offset) * binHz;
+        if (hz < MIN_FUNDAMENTAL_HZ)
+            continue;
+
+        const int midi = (int) std::lround (69.0f + 12.0f * std::log2 (hz / 440.0f));
+        frame[((midi % 12) + 12) % 12] += std::log1p (COMPRESSION * magnitudeScale * m[0]);
+    }
+
+    float peak = 0.0f;
+    for (int pc = 0; pc < 12; ++pc)
+    {
+        smoothed[pc] = smoothing * smoothed[pc] + (1.0f - smoothing) * frame[pc];
+        peak = std::max (peak, smoothed[pc]);
+    }
+
+    int active = 0;
+    for (float v : smoothed)
+        if (v >= peak * ACTIVE_FRACTION)
+            ++active;
+
+    if (peak < MIN_ENERGY || active < MIN_ACTIVE_CLASSES)
+    {
+        chord = {};
+        chordMask = 0;
+        return;
+    }
+
+    float centred[12];
+    std::copy (std::begin (smoothed), std::end (smoothed), centred);
+    centre (centred);
+
+    auto score = [&centred] (const Template& t)
+    {
+        float sum = 0.0f;
+        for (int pc = 0; pc < 12; ++pc)
+            sum += centred[pc] * t.profile[pc];
+        return sum;
+    };
+
+    const Template* best = nullptr;
+    const Template* current = nullptr;
+    float bestScore = 0.0f, currentScore = 0.0f, notChordScore = 0.0f;
+
+    for (const auto& t : templates)
+    {
+        const float s = score (t);
+        if (! t.chord.isValid())
+        {
+            notChordScore = std::max (notChordScore, s);
+            continue;
+        }
+        if (s > bestScore)
+        {
+            bestScore = s;
+            best = &t;
+        }
+        if (t.chord == chord)
+        {
+            current = &t;
+            currentScore = s;
+        }
+    }
+
+    if (best == nullptr || bestScore < MIN_SCORE || notChordScore > bestScore + NOT_CHORD_MARGIN)
+    {
+        chord = {};
+        chordMask = 0;
+        return;
+    }
+
+    // Stay on the shown chord unless the new one is clearly better
+    if (current != nullptr && currentScore >= bestScore - HYSTERESIS)
+        return;
+
+    chord = best->chord;
+    chordMask = best->mask;
+}
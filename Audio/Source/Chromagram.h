@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../../Source/ChordTable.h"
+#include <vector>
+#include <cstdint>
+
+// Chord recognition from the analysis FFT. The spectral peaks of each frame are folded into 12
+// pitch classes and smoothed over time. The smoothed chroma is correlated with a template for
+// every chord shape in ChordTable.h at all 12 roots; each template weights in the harmonics a
+// plucked chord tone adds (its fifth and third an octave or two up), so a strummed triad matches
+// the triad rather than a larger chord. The templates are built up front, so a frame costs one
+// pass over the bins and a few hundred 12-element dot products.
+class Chromagram
+{
+public:
+    Chromagram();
+
+    // fftSize is the transform length the magnitudes come from; frameRateHz sets the smoothing
+    void prepare (double sampleRate, int fftSize, double frameRateHz);
+    void reset();
+
+    // Magnitudes of bins 0 .. fftSize / 2 - 1 for one analysis frame
+    void process (const float* magnitudes);
+
+    const float* getChroma() const              { return smoothed; }
+
+    // The recognised chord, invalid when nothing chord-like is sounding
+    const ShowMe::Chord& getChord() const       { return chord; }
+
+    // Pitch classes of the recognised chord, bit 0 = C; 0 when there is none
+    unsigned getChordMask() const               { return chordMask; }
+
+private:
+    struct Template
+    {
+        ShowMe::Chord chord;
+        unsigned mask = 0;
+        float profile[12] {};
+    };
+
+    // Removes the mean and scales to unit length
+    static void centre (float* values);
+
+    std::vector<Template> templates;
+    float binHz = 1.0f;
+    int firstBin = 1, lastBin = 0;
+    float magnitudeScale = 1.0f;
+    float smoothing = 0.0f;
+
+    float smoothed[12] {};
+    ShowMe::Chord chord;
+    unsigned chordMask = 0;
+};
@@ -0,0 +1,128 @@
+#include "DifferenceKernel.h"
+#include <algorithm>
+
+namespace {
+    const int MAX_DEFAULT_WORKERS = 3;
+}
+
+DifferenceKernel::DifferenceKernel (int numWorkers)
+{
+    startWorkers (numWorkers);
+}
+
+DifferenceKernel::~DifferenceKernel()
+{
+    stopWorkers();
+}
+
+int DifferenceKernel::getDefaultNumWorkers()
+{
+    const int cores = (int) std::thread::hardware_concurrency();
+    return std::clamp (cores - 1, 0, MAX_DEFAULT_WORKERS);
+}
+
+void DifferenceKernel::setNumWorkers (int numWorkers)
+{
+    if (numWorkers == getNumWorkers())
+        return;
+
+    stopWorkers();
+    startWorkers (numWorkers);
+}
+
+void DifferenceKernel::startWorkers (int numWorkers)
+{
+    uint32_t current = 0;
+    {
+        const std::lock_guard<std::mutex> lock (wakeLock);
+        quit = false;
+        current = generation;
+    }
+
+    // Part 0 is the caller's, so worker i takes part i + 1. Workers start from the current
+    // generation, so a job posted before a thread gets going is not missed.
+    for (int i = 0; i < std::max (0, numWorkers); ++i)
+        workers.emplace_back ([this, i, current] { workerLoop (i + 1, current); });
+}
+
+void DifferenceKernel::stopWorkers()
+{
+    {
+        const std::lock_guard<std::mutex> lock (wakeLock);
+        quit = true;
+    }
+    wake.notify_all();
+
+    for (auto& t : workers)
+        t.join();
+    workers.clear();
+}
+
+void DifferenceKernel::workerLoop (int part, uint32_t seen)
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock (wakeLock);
+            wake.wait (lock, [&] { return quit || generation != seen; });
+            if (quit)
+                return;
+            seen = generation;
+        }
+
+        computePart (part);
+        partsRemaining.fetch_sub (1, std::memory_order_release);
+    }
+}
+
+void DifferenceKernel::compute (const float* x, int halfSize, float* out, bool forceParallel)
+{
+    if (workers.empty() || (halfSize < PARALLEL_MIN_HALF_SIZE && ! forceParallel))
+    {
+        computeRange (x, halfSize, 1, halfSize, out);
+        return;
+    }
+
+    jobInput = x;
+    jobOutput = out;
+    jobHalfSize = halfSize;
+    partsRemaining.store ((int) workers.size(), std::memory_order_relaxed);
+
+    {
+        // Taking the lock also publishes the job to the workers
+        const std::lock_guard<std::mutex> lock (wakeLock);
+        ++generation;
+    }
+    wake.notify_all();
+
+    computePart (0);
+
+    while (partsRemaining.load (std::memory_order_acquire) != 0)
+        std::this_thread::yield();
+}
+
+void DifferenceKernel::computePart (int part)
+{
+    // Every tau costs the same, so equal slices balance
+    const int numParts = (int) workers.size() + 1;
+    const int64_t taus = jobHalfSize - 1;
+    const int begin = 1 + (int) (taus * part / numParts);
+    const int end = 1 + (int) (taus * (part + 1) / numParts);
+
+    computeRange (jobInput, jobHalfSize, begin, end, jobOutput);
+}
+
+void DifferenceKernel::computeRange (const float* x, int halfSize, int tauBegin, int tauEnd, float* out)
+{
+    for (int tau = tauBegin; tau < tauEnd; ++tau)
+    {
+        const float* shifted = x + tau;
+        float sum = 0.0f;
+        for (int j = 0; j < halfSize; ++j)
+        {
+            const float delta = x[j] - shifted[j];
+            sum += delta * delta;
+        }
+        out[tau] = sum;
+    }
+}
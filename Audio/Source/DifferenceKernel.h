@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// The YIN difference function d(tau) = sum over j < halfSize of (x[j] - x[j + tau])^2, the
+// O(halfSize^2) part of pitch detection. Long windows split the tau range across a few pooled
+// worker threads plus the caller. Every tau is still summed by the one serial loop in the same
+// order, so the parallel result is bit-identical to the serial one.
+class DifferenceKernel
+{
+public:
+    // Below this half window the wake-up and join cost more than the split saves
+    static constexpr int PARALLEL_MIN_HALF_SIZE = 4096;
+
+    explicit DifferenceKernel (int numWorkers = getDefaultNumWorkers());
+    ~DifferenceKernel();
+
+    // Not while compute() is running
+    void setNumWorkers (int numWorkers);
+    int getNumWorkers() const                   { return (int) workers.size(); }
+
+    // A few cores at most; the host and the audio thread need the rest
+    static int getDefaultNumWorkers();
+
+    // Fills out[1 .. halfSize - 1] from x[0 .. 2 * halfSize - 1]. Uses the workers from
+    // PARALLEL_MIN_HALF_SIZE up, or always when forceParallel is set. One caller at a time.
+    void compute (const float* x, int halfSize, float* out, bool forceParallel = false);
+
+    // The serial loop, for taus in [tauBegin, tauEnd)
+    static void computeRange (const float* x, int halfSize, int tauBegin, int tauEnd, float* out);
+
+private:
+    void startWorkers (int numWorkers);
+    void stopWorkers();
+    void workerLoop (int part, uint32_t seen);
+    void computePart (int part);
+
+    std::vector<std::thread> workers;
+
+    // The current job, published by bumping generation
+    const float* jobInput = nullptr;
+    float* jobOutput = nullptr;
+    int jobHalfSize = 0;
+
+    std::mutex wakeLock;
+    std::condition_variable wake;
+    uint32_t generation = 0;            // Guarded by wakeLock
+    bool quit = false;                  // Guarded by wakeLock
+
+    // Join barrier: each worker counts itself out, the caller spins until it reaches zero
+    std::atomic<int> partsRemaining { 0 };
+
+    DifferenceKernel (const DifferenceKernel&) = delete;
+    DifferenceKernel& operator= (const DifferenceKernel&) = delete;
+};
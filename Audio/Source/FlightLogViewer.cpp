@@ -0,0 +1,226 @@
+#include "FlightLogViewer.h"
+#include "../../Source/Scales.h"
+#include <cmath>
+
+namespace {
+    const juce::Colour bgDark (18, 18, 22);
+    const juce::Colour panelBg (28, 28, 34);
+    const juce::Colour textBright (235, 235, 240);
+    const juce::Colour textDim (120, 120, 130);
+    const juce::Colour activeNoteColor (82, 209, 152);
+    const juce::Colour rejectedColor (200, 100, 100);
+    const juce::Colour holdingColor (200, 160, 80);
+
+    // Plotted pitch range, in MIDI notes
+    const float LOWEST_NOTE = 24.0f;
+    const float HIGHEST_NOTE = 96.0f;
+
+    const int MIN_VISIBLE_RECORDS = 50;
+
+    float toMidi (float hz)
+    {
+        return 69.0f + 12.0f * std::log2 (hz / 440.0f);
+    }
+}
+
+FlightLogViewer::FlightLogViewer (std::unique_ptr<FlightLog> l)
+    : log (std::move (l))
+{
+    const auto numRecords = (double) log->getNumRecords();
+    scrollBar.setRangeLimits (0.0, numRecords);
+    scrollBar.setCurrentRange (0.0, numRecords);
+    scrollBar.setAutoHide (false);
+    scrollBar.addListener (this);
+    addAndMakeVisible (scrollBar);
+
+    exportButton.onClick = [this] { exportCsv(); };
+    addAndMakeVisible (exportButton);
+
+    statusText = juce::String (log->getNumRecords()) + " frames in " + log->getSessionDirectory().getFileName();
+}
+
+void FlightLogViewer::resized()
+{
+    auto bounds = getLocalBounds().reduced (8);
+
+    auto top = bounds.removeFromTop (24);
+    exportButton.setBounds (top.removeFromRight (110));
+    infoArea = top;
+
+    scrollBar.setBounds (bounds.removeFromBottom (14));
+    bounds.removeFromBottom (4);
+    plotArea = bounds;
+}
+
+void FlightLogViewer::scrollBarMoved (juce::ScrollBar*, double)
+{
+    repaint();
+}
+
+int64_t FlightLogViewer::getRecordAt (float x) const
+{
+    const auto range = scrollBar.getCurrentRange();
+    const double t = (x - plotArea.getX()) / juce::jmax (1, plotArea.getWidth());
+    const auto index = (int64_t) (range.getStart() + t * range.getLength());
+    return juce::jlimit<int64_t> (0, log->getNumRecords() - 1, index);
+}
+
+void FlightLogViewer::mouseMove (const juce::MouseEvent& e)
+{
+    hoverRecord = plotArea.contains (e.getPosition()) ? getRecordAt ((float) e.x) : -1;
+    repaint();
+}
+
+void FlightLogViewer::mouseExit (const juce::MouseEvent&)
+{
+    hoverRecord = -1;
+    repaint();
+}
+
+void FlightLogViewer::mouseWheelMove (const juce::MouseEvent& e, const juce::MouseWheelDetails& wheel)
+{
+    // Zoom around the frame under the mouse
+    const auto range = scrollBar.getCurrentRange();
+    const double anchor = (double) getRecordAt ((float) e.x);
+    const double factor = wheel.deltaY > 0 ? 0.8 : 1.25;
+    const double length = juce::jlimit ((double) MIN_VISIBLE_RECORDS, (double) log->getNumRecords(), range.getLength() * factor);
+    const double start = anchor - (anchor - range.getStart()) * (length / range.getLength());
+
+    scrollBar.setCurrentRange (start, length);
+    repaint();
+}
+
+juce::String FlightLogViewer::describeRecord (int64_t index) const
+{
+    const auto& r = log->getRecord (index);
+    const int minutes = (int) (r.timeSeconds / 60.0);
+    const double seconds = r.timeSeconds - minutes * 60.0;
+
+    juce::String note = "-";
+    if (r.shownNote >= 0)
+        note = juce::String (ShowMe::NOTE_NAMES[r.shownNote % 12]) + juce::String (r.shownNote / 12 - 1);
+
+    return juce::String::formatted ("%d:%06.3f  RMS %.5f  raw %.1f Hz  conf %.2f  shown ", minutes, seconds,
+                                    r.rms, r.rawPitch, r.confidence)
+           + note + "  " + FlightLog::getDecisionName (r.decision);
+}
+
+void FlightLogViewer::paint (juce::Graphics& g)
+{
+    g.fillAll (bgDark);
+
+    g.setColour (textDim);
+    g.setFont (juce::Font (juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+    g.drawText (hoverRecord >= 0 ? describeRecord (hoverRecord) : statusText, infoArea, juce::Justification::centredLeft);
+
+    g.setColour (panelBg);
+    g.fillRect (plotArea);
+
+    const auto range = scrollBar.getCurrentRange();
+    const int width = plotArea.getWidth();
+    if (width <= 0 || log->getNumRecords() == 0)
+        return;
+
+    // Pitch lanes on top, confidence below, decisions as a strip along the bottom
+    auto area = plotArea;
+    const auto decisionLane = area.removeFromBottom (6);
+    const auto confidenceLane = area.removeFromBottom (area.getHeight() / 5);
+    const auto pitchLane = area;
+
+    auto yForNote = [&] (float midi)
+    {
+        const float t = (juce::jlimit (LOWEST_NOTE, HIGHEST_NOTE, midi) - LOWEST_NOTE) / (HIGHEST_NOTE - LOWEST_NOTE);
+        return pitchLane.getBottom() - t * pitchLane.getHeight();
+    };
+
+    g.setFont (9.0f);
+    for (int octave = 1; octave <= 7; ++octave)
+    {
+        const float y = yForNote ((float) (octave + 1) * 12.0f);
+        g.setColour (textDim.withAlpha (0.2f));
+        g.drawHorizontalLine ((int) y, (float) pitchLane.getX(), (float) pitchLane.getRight());
+        g.setColour (textDim);
+        g.drawText ("C" + juce::String (octave), pitchLane.getX() + 2, (int) y - 11, 24, 10, juce::Justification::bottomLeft);
+    }
+
+    const double perColumn = range.getLength() / width;
+    for (int x = 0; x < width; ++x)
+    {
+        const auto first = (int64_t) (range.getStart() + x * perColumn);
+        const auto last = juce::jmin (log->getNumRecords(), juce::jmax (first + 1, (int64_t) (range.getStart() + (x + 1) * perColumn)));
+
+        float rawLo = 1000.0f, rawHi = -1.0f, shownLo = 1000.0f, shownHi = -1.0f, confidence = 0.0f;
+        unsigned decisions = 0;
+        for (auto i = first; i < last; ++i)
+        {
+            const auto& r = log->getRecord (i);
+            if (r.rawPitch > 20.0f)
+            {
+                const float m = toMidi (r.rawPitch);
+                rawLo = juce::jmin (rawLo, m);
+                rawHi = juce::jmax (rawHi, m);
+            }
+            if (r.shownPitch > 20.0f)
+            {
+                const float m = toMidi (r.shownPitch);
+                shownLo = juce::jmin (shownLo, m);
+                shownHi = juce::jmax (shownHi, m);
+            }
+            confidence = juce::jmax (confidence, r.confidence);
+            decisions |= 1u << r.decision;
+        }
+
+        const float px = (float) (plotArea.getX() + x);
+        if (rawHi >= 0.0f)
+        {
+            g.setColour (textDim.withAlpha (0.5f));
+            g.drawVerticalLine ((int) px, yForNote (rawHi) - 1.0f, yForNote (rawLo) + 1.0f);
+        }
+        if (shownHi >= 0.0f)
+        {
+            g.setColour (activeNoteColor);
+            g.drawVerticalLine ((int) px, yForNote (shownHi) - 1.0f, yForNote (shownLo) + 1.0f);
+        }
+
+        g.setColour (activeNoteColor.withAlpha (0.35f));
+        g.drawVerticalLine ((int) px, confidenceLane.getBottom() - confidence * confidenceLane.getHeight(), (float) confidenceLane.getBottom());
+
+        // The most telling decision in the column wins
+        juce::Colour strip = panelBg;
+        if (decisions & (1u << FlightRecorder::rejectedJump))   strip = rejectedColor;
+        else if (decisions & (1u << FlightRecorder::holding))   strip = holdingColor;
+        else if (decisions & (1u << FlightRecorder::accepted))  strip = activeNoteColor.darker (0.5f);
+        g.setColour (strip);
+        g.drawVerticalLine ((int) px, (float) decisionLane.getY(), (float) decisionLane.getBottom());
+    }
+
+    if (hoverRecord >= 0)
+    {
+        const float x = plotArea.getX() + (float) ((hoverRecord - range.getStart()) / range.getLength()) * width;
+        g.setColour (textBright.withAlpha (0.6f));
+        g.drawVerticalLine ((int) x, (float) plotArea.getY(), (float) plotArea.getBottom());
+    }
+}
+
+void FlightLogViewer::exportCsv()
+{
+    const auto defaultFile = log->getSessionDirectory().getSiblingFile (log->getSessionDirectory().getFileName() + ".csv");
+    chooser = std::make_unique<juce::FileChooser> ("Export recording as CSV", defaultFile, "*.csv");
+
+    chooser->launchAsync (juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+                              | juce::FileBrowserComponent::warnAboutOverwriting,
+        [safeThis = juce::Component::SafePointer<FlightLogViewer> (this)] (const juce::FileChooser& fc)
+        {
+            if (safeThis == nullptr || fc.getResult() == juce::File())
+                return;
+
+            const double startMs = juce::Time::getMillisecondCounterHiRes();
+            const auto error = safeThis->log->exportCsv (fc.getResult());
+            const double elapsedMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+
+            safeThis->statusText = error.isNotEmpty() ? error
+                : juce::String (safeThis->log->getNumRecords()) + " frames exported to " + fc.getResult().getFileName()
+                      + " in " + juce::String (juce::roundToInt (elapsedMs)) + " ms";
+            safeThis->repaint();
+        });
+}
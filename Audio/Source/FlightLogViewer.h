@@ -0,0 +1,39 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "FlightRecorder.h"
+
+// Seekable view of a recorded session: raw and shown pitch, confidence and the analyser's
+// decision for every frame. Drag the scroll bar to seek, use the mouse wheel to zoom, and
+// hover to read a single frame. Each column of the plot summarises the frames under it, so
+// paint cost follows the width of the view rather than the length of the recording.
+class FlightLogViewer : public juce::Component,
+                        private juce::ScrollBar::Listener
+{
+public:
+    explicit FlightLogViewer (std::unique_ptr<FlightLog> log);
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+    void mouseMove (const juce::MouseEvent& e) override;
+    void mouseExit (const juce::MouseEvent& e) override;
+    void mouseWheelMove (const juce::MouseEvent& e, const juce::MouseWheelDetails& wheel) override;
+
+private:
+    void scrollBarMoved (juce::ScrollBar* bar, double newRangeStart) override;
+    void exportCsv();
+    int64_t getRecordAt (float x) const;
+    juce::String describeRecord (int64_t index) const;
+
+    std::unique_ptr<FlightLog> log;
+
+    juce::ScrollBar scrollBar { false };
+    juce::TextButton exportButton { "Export CSV..." };
+    std::unique_ptr<juce::FileChooser> chooser;
+
+    juce::Rectangle<int> infoArea, plotArea;
+    int64_t hoverRecord = -1;
+    juce::String statusText;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlightLogViewer)
+};
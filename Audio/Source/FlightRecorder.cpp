@@ -0,0 +1,321 @@
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const int WRITE_INTERVAL_MS = 50;
+    const char MAGIC[4] = { 'S', 'M', 'F', 'R' };
+
+    juce::String getSegmentFileName (uint32_t index)
+    {
+        return juce::String::formatted ("segment-%04u.bin", (unsigned) index);
+    }
+}
+
+//==============================================================================
+// Drains the queue into the current memory-mapped segment, opening the next when it fills
+class FlightRecorder::Writer : public juce::Thread
+{
+public:
+    Writer (FlightRecorder& o, const juce::File& dir, double sr, juce::int64 startMs)
+        : juce::Thread ("Flight recorder"), owner (o), directory (dir), sampleRate (sr), sessionStartMs (startMs)
+    {
+    }
+
+    ~Writer() override
+    {
+        stopThread (2000);
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            drain();
+            wait (WRITE_INTERVAL_MS);
+        }
+
+        drain();
+        closeSegment();
+    }
+
+private:
+    void drain()
+    {
+        const int ready = owner.queue.getNumReady();
+        if (ready == 0)
+            return;
+
+        int start1, size1, start2, size2;
+        owner.queue.prepareToRead (ready, start1, size1, start2, size2);
+        append (owner.queued.data() + start1, size1);
+        append (owner.queued.data() + start2, size2);
+        owner.queue.finishedRead (size1 + size2);
+    }
+
+    void append (const Record* source, int count)
+    {
+        while (count > 0)
+        {
+            if (header == nullptr || header->numRecords == header->capacity)
+            {
+                if (! openSegment())
+                {
+                    owner.dropped += count;
+                    return;
+                }
+            }
+
+            const int n = juce::jmin (count, (int) (header->capacity - header->numRecords));
+            std::memcpy (records + header->numRecords, source, (size_t) n * sizeof (Record));
+            header->numRecords += (uint32_t) n;
+            source += n;
+            count -= n;
+        }
+    }
+
+    bool openSegment()
+    {
+        closeSegment();
+
+        const auto file = directory.getChildFile (getSegmentFileName (nextSegment));
+        const size_t recordBytes = (size_t) RECORDS_PER_SEGMENT * sizeof (Record);
+
+        // Size the file up front so the mapping never has to grow
+        {
+            juce::FileOutputStream out (file);
+            if (! out.openedOk())
+                return false;
+
+            out.setPosition (0);
+            out.truncate();
+
+            SegmentHeader h {};
+            std::memcpy (h.magic, MAGIC, sizeof (MAGIC));
+            h.version = FORMAT_VERSION;
+            h.recordSize = (uint32_t) sizeof (Record);
+            h.capacity = RECORDS_PER_SEGMENT;
+            h.segmentIndex = nextSegment;
+            h.numRecords = 0;
+            h.sampleRate = sampleRate;
+            h.sessionStartMs = sessionStartMs;
+
+            out.write (&h, sizeof (h));
+            out.writeRepeatedByte (0, recordBytes);
+            out.flush();
+            if (out.getStatus().failed())
+                return false;
+        }
+
+        mapping = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readWrite);
+        if (mapping->getData() == nullptr || mapping->getSize() < sizeof (SegmentHeader) + recordBytes)
+        {
+            mapping.reset();
+            return false;
+        }
+
+        header = static_cast<SegmentHeader*> (mapping->getData());
+        records = reinterpret_cast<Record*> (header + 1);
+
+        if (nextSegment >= (uint32_t) MAX_SEGMENTS)
+            directory.getChildFile (getSegmentFileName (nextSegment - (uint32_t) MAX_SEGMENTS)).deleteFile();
+
+        ++nextSegment;
+        return true;
+    }
+
+    void closeSegment()
+    {
+        header = nullptr;
+        records = nullptr;
+        mapping.reset();
+    }
+
+    FlightRecorder& owner;
+    const juce::File directory;
+    const double sampleRate;
+    const juce::int64 sessionStartMs;
+
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+    SegmentHeader* header = nullptr;
+    Record* records = nullptr;
+    uint32_t nextSegment = 0;
+};
+
+//==============================================================================
+FlightRecorder::FlightRecorder()
+{
+    queued.resize (QUEUE_SIZE);
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    stop();
+}
+
+juce::File FlightRecorder::getDefaultRecordingsDirectory()
+{
+    return juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+               .getChildFile ("ShowMe").getChildFile ("FlightRecorder");
+}
+
+juce::File FlightRecorder::createSessionDirectory()
+{
+    return getDefaultRecordingsDirectory()
+               .getNonexistentChildFile ("session-" + juce::Time::getCurrentTime().formatted ("%Y-%m-%d_%H-%M-%S"), {}, false);
+}
+
+juce::String FlightRecorder::start (const juce::File& sessionDirectory, double sampleRate)
+{
+    stop();
+
+    if (! sessionDirectory.createDirectory())
+        return "Cannot create " + sessionDirectory.getFullPathName();
+
+    queue.reset();
+    dropped = 0;
+    sessionDir = sessionDirectory;
+    startSeconds = juce::Time::getMillisecondCounterHiRes() * 0.001;
+
+    writer = std::make_unique<Writer> (*this, sessionDirectory, sampleRate, juce::Time::currentTimeMillis());
+    writer->startThread();
+    recording = true;
+    return {};
+}
+
+void FlightRecorder::stop()
+{
+    recording = false;
+    writer.reset();     // Joins after the last records are written
+}
+
+void FlightRecorder::record (Record r)
+{
+    if (! recording.load())
+        return;
+
+    r.timeSeconds = juce::Time::getMillisecondCounterHiRes() * 0.001 - startSeconds;
+
+    int start1, size1, start2, size2;
+    queue.prepareToWrite (1, start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+    {
+        ++dropped;
+        return;
+    }
+
+    queued[(size_t) (size1 > 0 ? start1 : start2)] = r;
+    queue.finishedWrite (1);
+}
+
+//==============================================================================
+juce::String FlightLog::open (const juce::File& sessionDirectory)
+{
+    segments.clear();
+    totalRecords = 0;
+    sampleRate = 0.0;
+    sessionDir = sessionDirectory;
+
+    if (! sessionDirectory.isDirectory())
+        return sessionDirectory.getFullPathName() + " is not a folder";
+
+    struct Found
+    {
+        uint32_t index;
+        Segment segment;
+    };
+    std::vector<Found> found;
+
+    for (const auto& file : sessionDirectory.findChildFiles (juce::File::findFiles, false, "segment-*.bin"))
+    {
+        auto mapping = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readOnly);
+        if (mapping->getData() == nullptr || mapping->getSize() < sizeof (FlightRecorder::SegmentHeader))
+            continue;
+
+        const auto* h = static_cast<const FlightRecorder::SegmentHeader*> (mapping->getData());
+        if (std::memcmp (h->magic, MAGIC, sizeof (MAGIC)) != 0 || h->version != FlightRecorder::FORMAT_VERSION
+             || h->recordSize != sizeof (FlightRecorder::Record))
+            continue;
+
+        // Never trust the count beyond what the file actually holds
+        const auto fits = (int64_t) ((mapping->getSize() - sizeof (FlightRecorder::SegmentHeader)) / sizeof (FlightRecorder::Record));
+        const int64_t count = std::min<int64_t> ({ (int64_t) h->numRecords, (int64_t) h->capacity, fits });
+        if (count <= 0)
+            continue;
+
+        if (sampleRate == 0.0)
+            sampleRate = h->sampleRate;
+
+        Segment segment;
+        segment.records = reinterpret_cast<const FlightRecorder::Record*> (h + 1);
+        segment.numRecords = count;
+        segment.mapping = std::move (mapping);
+        found.push_back ({ h->segmentIndex, std::move (segment) });
+    }
+
+    if (found.empty())
+        return "No recorded frames in " + sessionDirectory.getFileName();
+
+    std::sort (found.begin(), found.end(), [] (const Found& a, const Found& b) { return a.index < b.index; });
+    for (auto& f : found)
+    {
+        f.segment.firstRecord = totalRecords;
+        totalRecords += f.segment.numRecords;
+        segments.push_back (std::move (f.segment));
+    }
+
+    return {};
+}
+
+const FlightRecorder::Record& FlightLog::getRecord (int64_t index) const
+{
+    jassert (index >= 0 && index < totalRecords);
+
+    auto it = std::upper_bound (segments.begin(), segments.end(), index,
+                                [] (int64_t i, const Segment& s) { return i < s.firstRecord; });
+    const auto& segment = *(it - 1);
+    return segment.records[index - segment.firstRecord];
+}
+
+const char* FlightLog::getDecisionName (uint8_t decision)
+{
+    switch (decision)
+    {
+        case FlightRecorder::silent:        return "silent";
+        case FlightRecorder::accepted:      return "accepted";
+        case FlightRecorder::rejectedJump:  return "rejected_jump";
+        case FlightRecorder::holding:       return "holding";
+        default:                            return "unknown";
+    }
+}
+
+juce::String FlightLog::exportCsv (const juce::File& destination) const
+{
+    destination.deleteFile();
+    juce::FileOutputStream out (destination, 1 << 20);
+    if (! out.openedOk())
+        return "Cannot write " + destination.getFullPathName();
+
+    static const char header[] = "Time,SamplePosition,RMS,RawPitch,Confidence,ShownPitch,ShownNote,ShownCents,Decision\n";
+    out.write (header, sizeof (header) - 1);
+
+    // One fixed buffer per line and a large stream buffer; no string building
+    char line[200];
+    for (const auto& segment : segments)
+    {
+        for (int64_t i = 0; i < segment.numRecords; ++i)
+        {
+            const auto& r = segment.records[i];
+            const int n = std::snprintf (line, sizeof (line), "%.4f,%lld,%.8f,%.2f,%.3f,%.2f,%d,%.1f,%s\n",
+                                         r.timeSeconds, (long long) r.samplePosition, r.rms, r.rawPitch,
+                                         r.confidence, r.shownPitch, (int) r.shownNote, r.shownCents,
+                                         getDecisionName (r.decision));
+            out.write (line, (size_t) juce::jlimit (0, (int) sizeof (line) - 1, n));
+        }
+    }
+
+    out.flush();
+    if (out.getStatus().failed())
+        return "Writing " + destination.getFileName() + " failed: " + out.getStatus().getErrorMessage();
+    return {};
+}
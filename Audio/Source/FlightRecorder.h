@@ -0,0 +1,121 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Records every analysis frame of a session to disk so long sets can be inspected afterwards.
+// The analysis thread hands records to a lock-free queue; a background writer copies them into
+// fixed-size memory-mapped segment files (segment-0000.bin, ...) in a session directory.
+// When MAX_SEGMENTS is reached the oldest segment is deleted, so disk use stays bounded.
+class FlightRecorder
+{
+public:
+    // What the analyser did with the frame
+    enum Decision : uint8_t
+    {
+        silent,             // No usable pitch, nothing held
+        accepted,           // Pitch shown
+        rejectedJump,       // Pitch rejected by the jump protection, last note kept
+        holding             // No usable pitch, last note held
+    };
+
+    struct Record
+    {
+        double timeSeconds;         // Since recording started
+        int64_t samplePosition;
+        float rms;
+        float rawPitch;
+        float confidence;
+        float shownPitch;
+        int16_t shownNote;
+        uint8_t decision;
+        uint8_t reserved;
+        float shownCents;
+    };
+    static_assert (sizeof (Record) == 40, "Record layout is part of the file format");
+
+    struct SegmentHeader
+    {
+        char magic[4];              // "SMFR"
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t capacity;          // Records the segment can hold
+        uint32_t segmentIndex;
+        uint32_t numRecords;        // Records written so far
+        double sampleRate;
+        int64_t sessionStartMs;     // Wall clock, ms since the epoch
+        uint8_t reserved[24];
+    };
+    static_assert (sizeof (SegmentHeader) == 64, "Header layout is part of the file format");
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr uint32_t RECORDS_PER_SEGMENT = 32768;   // About 11 minutes at 50 frames a second
+    static constexpr int MAX_SEGMENTS = 64;
+
+    FlightRecorder();
+    ~FlightRecorder();
+
+    // Message thread. Starts a new session in sessionDirectory; returns an error message, or empty on success.
+    juce::String start (const juce::File& sessionDirectory, double sampleRate);
+    void stop();
+
+    bool isRecording() const                    { return recording.load(); }
+    juce::File getSessionDirectory() const      { return sessionDir; }
+    int getNumDropped() const                   { return dropped.load(); }
+
+    // Where sessions go unless the caller picks somewhere else
+    static juce::File getDefaultRecordingsDirectory();
+    static juce::File createSessionDirectory();
+
+    // Analysis thread. Lock free; the record is dropped if the writer has fallen behind.
+    void record (Record r);
+
+private:
+    class Writer;
+
+    static constexpr int QUEUE_SIZE = 4096;
+    juce::AbstractFifo queue { QUEUE_SIZE };
+    std::vector<Record> queued;
+
+    std::atomic<bool> recording { false };
+    std::atomic<int> dropped { 0 };
+    double startSeconds = 0.0;
+    juce::File sessionDir;
+    std::unique_ptr<Writer> writer;
+
+    JUCE_DECLARE_NON_COPYABLE (FlightRecorder)
+};
+
+// Read-only view of a recorded session, for the viewer and the exporter
+class FlightLog
+{
+public:
+    // Maps every segment in the directory; returns an error message, or empty on success
+    juce::String open (const juce::File& sessionDirectory);
+
+    int64_t getNumRecords() const               { return totalRecords; }
+    const FlightRecorder::Record& getRecord (int64_t index) const;
+    double getSampleRate() const                { return sampleRate; }
+    const juce::File& getSessionDirectory() const { return sessionDir; }
+
+    // Writes all records as CSV; returns an error message, or empty on success
+    juce::String exportCsv (const juce::File& destination) const;
+
+    static const char* getDecisionName (uint8_t decision);
+
+private:
+    struct Segment
+    {
+        std::unique_ptr<juce::MemoryMappedFile> mapping;
+        const FlightRecorder::Record* records = nullptr;
+        int64_t firstRecord = 0;
+        int64_t numRecords = 0;
+    };
+
+    std::vector<Segment> segments;
+    int64_t totalRecords = 0;
+    double sampleRate = 0.0;
+    juce::File sessionDir;
+};
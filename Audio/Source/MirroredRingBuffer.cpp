@@ -0,0 +1,101 @@
+#include "MirroredRingBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined (__linux__)
+ #include <sys/mman.h>
+ #include <unistd.h>
+#endif
+
+MirroredRingBuffer::~MirroredRingBuffer()
+{
+    release();
+}
+
+void MirroredRingBuffer::allocate (int minSize, int newMaxWindow)
+{
+    release();
+
+    size = std::max (1, minSize);
+
+   #if defined (__linux__)
+    // Both halves must be whole pages
+    const auto pageFloats = std::max<long> (1, sysconf (_SC_PAGESIZE) / (long) sizeof (float));
+    const auto rounded = (int) (((size + pageFloats - 1) / pageFloats) * pageFloats);
+
+    if (mapMirrored ((std::size_t) rounded * sizeof (float)))
+    {
+        size = rounded;
+        maxWindow = std::min (newMaxWindow, size);
+        return;
+    }
+   #endif
+
+    maxWindow = std::min (newMaxWindow, size);
+    fallback.assign ((std::size_t) (size + maxWindow), 0.0f);
+    data = fallback.data();
+}
+
+bool MirroredRingBuffer::mapMirrored (std::size_t bytes)
+{
+   #if defined (__linux__)
+    const int fd = memfd_create ("ShowMeRing", MFD_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    if (ftruncate (fd, (off_t) bytes) != 0)
+    {
+        close (fd);
+        return false;
+    }
+
+    // Reserve the address range first so nothing else can land between the two views
+    auto* base = static_cast<char*> (mmap (nullptr, bytes * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    bool ok = base != MAP_FAILED;
+
+    if (ok)
+    {
+        ok = mmap (base, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED
+          && mmap (base + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+
+        if (! ok)
+            munmap (base, bytes * 2);
+    }
+
+    close (fd);     // The mappings keep the pages alive
+    if (! ok)
+        return false;
+
+    mapping = base;
+    mappedBytes = bytes * 2;
+    data = reinterpret_cast<float*> (base);     // memfd pages start out zeroed
+    return true;
+   #else
+    (void) bytes;
+    return false;
+   #endif
+}
+
+void MirroredRingBuffer::clear()
+{
+    // Through the mapping, clearing the first view clears both
+    const int count = mapping != nullptr ? size : size + maxWindow;
+    if (data != nullptr)
+        std::memset (data, 0, (std::size_t) count * sizeof (float));
+}
+
+void MirroredRingBuffer::release()
+{
+   #if defined (__linux__)
+    if (mapping != nullptr)
+        munmap (mapping, mappedBytes);
+   #endif
+
+    mapping = nullptr;
+    mappedBytes = 0;
+    fallback.clear();
+    fallback.shrink_to_fit();
+    data = nullptr;
+    size = 0;
+    maxWindow = 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Sample ring where any window of up to getMaxWindow() samples is contiguous in memory, so
+// readers can use it in place instead of copying it out with a wrap per sample.
+// On Linux the same memfd pages are mapped twice, back to back: index size + i is index i,
+// and the whole ring is a valid window. Elsewhere, or if mapping fails, the ring is followed
+// by a copy of its first maxWindow samples that every write keeps up to date.
+class MirroredRingBuffer
+{
+public:
+    MirroredRingBuffer() = default;
+    ~MirroredRingBuffer();
+
+    // Allocates at least minSize samples, zeroed; windows up to maxWindow long stay contiguous.
+    // The size may be rounded up to whole pages, so index with getSize(), not minSize.
+    void allocate (int minSize, int maxWindow);
+    void clear();
+
+    int getSize() const                         { return size; }
+    int getMaxWindow() const                    { return maxWindow; }
+    bool isMirrored() const                     { return mapping != nullptr; }
+
+    void write (int index, float sample)
+    {
+        data[index] = sample;
+        if (mapping == nullptr && index < maxWindow)
+            data[size + index] = sample;
+    }
+
+    // The numSamples samples that end just before absolute position end (numSamples <= getMaxWindow())
+    const float* getWindow (int64_t end, int numSamples) const
+    {
+        const int64_t start = (end - numSamples) % size;
+        return data + (start < 0 ? start + size : start);
+    }
+
+private:
+    void release();
+    bool mapMirrored (std::size_t bytes);
+
+    float* data = nullptr;
+    int size = 0;
+    int maxWindow = 0;
+
+    void* mapping = nullptr;        // Start of the double mapping, null when using the fallback
+    std::size_t mappedBytes = 0;
+    std::vector<float> fallback;
+
+    MirroredRingBuffer (const MirroredRingBuffer&) = delete;
+    MirroredRingBuffer& operator= (const MirroredRingBuffer&) = delete;
+};
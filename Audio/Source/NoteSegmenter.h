@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Turns per-frame pitch results into discrete notes with an onset, an offset, a median pitch
+// and a confidence. A note starts after a few consecutive frames agree on a pitch, ends after
+// a few unvoiced frames, and is split on a stable pitch change or a re-attack at the same pitch.
+// Fixed storage and O(1) work per frame (O(MAX_PITCHES) when a note ends), no allocation.
+class NoteSegmenter
+{
+public:
+    struct Frame
+    {
+        int64_t samplePosition;     // Newest sample the frame was computed from
+        float pitch;                // Hz, 0 when nothing was found
+        float confidence;
+        float level;                // RMS
+    };
+
+    struct NoteEvent
+    {
+        enum Type : uint8_t { noteStarted, noteFinished };
+
+        Type type;
+        int midiNote;
+        int64_t onsetSample;
+        int64_t offsetSample;       // -1 while the note is still sounding
+        float medianPitch;          // Hz; the onset pitch for noteStarted
+        float confidence;           // Mean over the note's frames
+        float level;                // Peak RMS
+    };
+
+    struct Settings
+    {
+        float confidenceThreshold = 0.62f;
+        float levelGate = 0.0005f;
+        int onsetFrames = 2;        // Agreeing frames before a note starts
+        int releaseFrames = 3;      // Unvoiced frames before a note ends
+        int changeFrames = 2;       // Frames at a new pitch before a sounding note is split
+        float reattackRatio = 2.0f; // Level jump that counts as picking the same note again
+    };
+
+    void reset()
+    {
+        sounding = false;
+        candidateNote = -1;
+        candidateRun = 0;
+        changeRun = 0;
+        silentRun = 0;
+    }
+
+    bool isSounding() const                     { return sounding; }
+
+    // Calls emit (const NoteEvent&) for each event the frame produces, at most two
+    template <typename Fn>
+    void process (const Frame& frame, const Settings& settings, Fn&& emit)
+    {
+        const bool voiced = frame.pitch > 20.0f && frame.confidence >= settings.confidenceThreshold
+                            && frame.level >= settings.levelGate;
+        const float midiFloat = voiced ? 69.0f + 12.0f * std::log2 (frame.pitch / 440.0f) : 0.0f;
+        const int nearest = (int) std::round (midiFloat);
+
+        if (! sounding)
+        {
+            if (! voiced)
+            {
+                candidateRun = 0;
+                return;
+            }
+
+            trackCandidate (candidateNote, candidateRun, candidateStart, nearest, frame.samplePosition);
+            if (candidateRun >= settings.onsetFrames)
+                start (candidateNote, candidateStart, frame, emit);
+            return;
+        }
+
+        if (! voiced)
+        {
+            if (++silentRun >= settings.releaseFrames)
+                finish (lastVoicedSample, emit);
+            return;
+        }
+        silentRun = 0;
+
+        if (std::abs (midiFloat - (float) note) <= SAME_NOTE_SEMITONES)
+        {
+            changeRun = 0;
+
+            // Picked again at the same pitch: the level jumps after having decayed
+            if (frame.level > lastLevel * settings.reattackRatio && lastLevel < peakLevel * 0.5f)
+            {
+                finish (frame.samplePosition, emit);
+                start (nearest, frame.samplePosition, frame, emit);
+                return;
+            }
+
+            accumulate (frame);
+            return;
+        }
+
+        // A different pitch has to hold for a few frames before the note is split (slides, vibrato)
+        trackCandidate (changeNote, changeRun, changeStart, nearest, frame.samplePosition);
+        lastLevel = frame.level;
+        if (changeRun >= settings.changeFrames)
+        {
+            const int newNote = changeNote;
+            const int64_t newStart = changeStart;
+            finish (newStart, emit);
+            start (newNote, newStart, frame, emit);
+        }
+    }
+
+    // Ends a sounding note, e.g. when the stream stops
+    template <typename Fn>
+    void flush (int64_t samplePosition, Fn&& emit)
+    {
+        if (sounding)
+            finish (samplePosition, emit);
+        reset();
+    }
+
+private:
+    static constexpr int MAX_PITCHES = 64;
+    static constexpr float SAME_NOTE_SEMITONES = 0.6f;
+
+    static void trackCandidate (int& candidate, int& run, int64_t& runStart, int nearest, int64_t position)
+    {
+        if (nearest == candidate && run > 0)
+        {
+            ++run;
+            return;
+        }
+        candidate = nearest;
+        run = 1;
+        runStart = position;
+    }
+
+    void accumulate (const Frame& frame)
+    {
+        pitches[numPitches % MAX_PITCHES] = frame.pitch;
+        ++numPitches;
+        confidenceSum += frame.confidence;
+        ++numFrames;
+        peakLevel = std::max (peakLevel, frame.level);
+        lastLevel = frame.level;
+        lastVoicedSample = frame.samplePosition;
+    }
+
+    template <typename Fn>
+    void start (int midiNote, int64_t onset, const Frame& frame, Fn&& emit)
+    {
+        sounding = true;
+        note = midiNote;
+        onsetSample = onset;
+        numPitches = 0;
+        numFrames = 0;
+        confidenceSum = 0.0f;
+        peakLevel = 0.0f;
+        candidateRun = 0;
+        changeRun = 0;
+        silentRun = 0;
+        accumulate (frame);
+
+        emit (NoteEvent { NoteEvent::noteStarted, note, onsetSample, -1, frame.pitch, frame.confidence, frame.level });
+    }
+
+    template <typename Fn>
+    void finish (int64_t offset, Fn&& emit)
+    {
+        // Median of the most recent MAX_PITCHES voiced frames
+        const int count = std::min (numPitches, MAX_PITCHES);
+        float sorted[MAX_PITCHES];
+        std::copy (pitches, pitches + count, sorted);
+        std::nth_element (sorted, sorted + count / 2, sorted + count);
+
+        sounding = false;
+        candidateRun = 0;
+        emit (NoteEvent { NoteEvent::noteFinished, note, onsetSample, std::max (offset, onsetSample),
+                          count > 0 ? sorted[count / 2] : 0.0f,
+                          numFrames > 0 ? confidenceSum / (float) numFrames : 0.0f, peakLevel });
+    }
+
+    bool sounding = false;
+    int note = -1;
+    int64_t onsetSample = 0;
+    int64_t lastVoicedSample = 0;
+
+    float pitches[MAX_PITCHES] {};
+    int numPitches = 0;
+    int numFrames = 0;
+    float confidenceSum = 0.0f;
+    float peakLevel = 0.0f;
+    float lastLevel = 0.0f;
+
+    int candidateNote = -1, candidateRun = 0;
+    int64_t candidateStart = 0;
+    int changeNote = -1, changeRun = 0;
+    int64_t changeStart = 0;
+    int silentRun = 0;
+};
@@ -0,0 +1,142 @@
+#include "PitchContour.h"
+#include <algorithm>
+#include <cmath>
+
+void PitchContour::prepare (double newSampleRate, float minHz, float maxHz, double hopSeconds)
+{
+    sampleRate = newSampleRate;
+    minTau = std::max (2, (int) (sampleRate / maxHz));
+    maxTau = std::max (minTau + 2, (int) std::ceil (sampleRate / minHz));
+
+    // Window at least one period of the lowest note, rounded up to a power of two
+    windowSize = 1;
+    while (windowSize < maxTau)
+        windowSize *= 2;
+
+    hopSize = std::max (1, (int) std::round (sampleRate * hopSeconds));
+    span = windowSize + maxTau;
+
+    buffer.assign ((size_t) (span + hopSize), 0.0f);
+    difference.assign ((size_t) (maxTau + 1), 0.0);
+    normalised.assign ((size_t) (maxTau + 1), 1.0f);
+
+    reset();
+    nextSamplePosition = -1;
+}
+
+void PitchContour::reset()
+{
+    filled = 0;
+    primed = false;
+    hopsSinceRefresh = 0;
+}
+
+PitchContour::Frame PitchContour::advance (int64_t newestSamplePosition)
+{
+    if (! primed)
+    {
+        computeFull();
+        primed = true;
+    }
+    else if (++hopsSinceRefresh >= REFRESH_HOPS)
+    {
+        std::copy (buffer.begin() + hopSize, buffer.end(), buffer.begin());
+        filled = span;
+        computeFull();
+        hopsSinceRefresh = 0;
+    }
+    else
+    {
+        slide();
+    }
+
+    return estimate (newestSamplePosition);
+}
+
+void PitchContour::computeFull()
+{
+    const float* x = buffer.data();
+    for (int tau = 1; tau <= maxTau; ++tau)
+    {
+        float sum = 0.0f;
+        for (int j = 0; j < windowSize; ++j)
+        {
+            const float delta = x[j] - x[j + tau];
+            sum += delta * delta;
+        }
+        difference[(size_t) tau] = sum;
+    }
+}
+
+void PitchContour::slide()
+{
+    // The window moves from [0, W) to [H, W + H): drop the first H products, add the next H
+    const float* x = buffer.data();
+    for (int tau = 1; tau <= maxTau; ++tau)
+    {
+        float removed = 0.0f, added = 0.0f;
+        for (int j = 0; j < hopSize; ++j)
+        {
+            const float out = x[j] - x[j + tau];
+            const float in = x[windowSize + j] - x[windowSize + j + tau];
+            removed += out * out;
+            added += in * in;
+        }
+        difference[(size_t) tau] = std::max (0.0, difference[(size_t) tau] + added - removed);
+    }
+
+    std::copy (buffer.begin() + hopSize, buffer.end(), buffer.begin());
+    filled = span;
+}
+
+PitchContour::Frame PitchContour::estimate (int64_t samplePosition)
+{
+    // Cumulative mean normalised difference, as in detectPitchYIN
+    double runningSum = 0.0;
+    normalised[0] = 1.0f;
+    for (int tau = 1; tau <= maxTau; ++tau)
+    {
+        runningSum += difference[(size_t) tau];
+        normalised[(size_t) tau] = runningSum > 0.0 ? (float) (difference[(size_t) tau] * tau / runningSum) : 1.0f;
+    }
+
+    int tauEstimate = 0;
+    for (int tau = minTau; tau < maxTau; ++tau)
+    {
+        if (normalised[(size_t) tau] < THRESHOLD)
+        {
+            while (tau + 1 < maxTau && normalised[(size_t) tau + 1] < normalised[(size_t) tau])
+                ++tau;
+            tauEstimate = tau;
+            break;
+        }
+    }
+
+    if (tauEstimate == 0)
+    {
+        float minValue = 1.0f;
+        for (int tau = minTau; tau < maxTau; ++tau)
+        {
+            if (normalised[(size_t) tau] < minValue)
+            {
+                minValue = normalised[(size_t) tau];
+                tauEstimate = tau;
+            }
+        }
+    }
+
+    if (tauEstimate == 0)
+        return { samplePosition, 0.0f, 0.0f };
+
+    // Parabolic interpolation for sub-sample lag
+    const float s0 = normalised[(size_t) tauEstimate - 1];
+    const float s1 = normalised[(size_t) tauEstimate];
+    const float s2 = normalised[(size_t) tauEstimate + 1];
+    const float denom = 2.0f * (2.0f * s1 - s2 - s0);
+    const float betterTau = std::abs (denom) > 1e-9f ? tauEstimate + (s0 - s2) / denom : (float) tauEstimate;
+
+    if (betterTau <= 0.0f)
+        return { samplePosition, 0.0f, 0.0f };
+
+    return { samplePosition, (float) (sampleRate / betterTau), 1.0f - s1 };
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Continuous pitch track for bends and vibrato, one estimate every few milliseconds.
+// Keeps the YIN difference function of a sliding window and updates it per hop by
+// removing the products that leave the window and adding the ones that enter, so a hop
+// costs O(maxTau * hop) instead of O(maxTau * window). A full recompute every
+// REFRESH_HOPS hops stops rounding error from building up.
+class PitchContour
+{
+public:
+    struct Frame
+    {
+        int64_t samplePosition;     // Absolute position of the newest sample in the window
+        float pitch;                // Hz, 0 when nothing periodic was found
+        float confidence;           // 1 - normalised difference at the chosen lag
+    };
+
+    void prepare (double sampleRate, float minHz, float maxHz, double hopSeconds);
+    void reset();
+
+    int getHopSize() const                      { return hopSize; }
+    int getWindowSize() const                   { return windowSize; }
+
+    // Feeds consecutive samples starting at firstSamplePosition. Calls onFrame (const Frame&)
+    // once per hop after the first window has filled. A gap in positions restarts the track.
+    template <typename Fn>
+    void process (const float* samples, int numSamples, int64_t firstSamplePosition, Fn&& onFrame)
+    {
+        if (firstSamplePosition != nextSamplePosition)
+            reset();
+        nextSamplePosition = firstSamplePosition + numSamples;
+
+        int64_t position = firstSamplePosition;
+        while (numSamples > 0)
+        {
+            const int needed = (primed ? span + hopSize : span) - filled;
+            const int n = numSamples < needed ? numSamples : needed;
+            for (int i = 0; i < n; ++i)
+                buffer[(std::size_t) (filled + i)] = samples[i];
+
+            filled += n;
+            samples += n;
+            numSamples -= n;
+            position += n;
+
+            if (n == needed)
+                onFrame (advance (position - 1));
+        }
+    }
+
+private:
+    Frame advance (int64_t newestSamplePosition);
+    void computeFull();
+    void slide();
+    Frame estimate (int64_t samplePosition);
+
+    static constexpr int REFRESH_HOPS = 64;
+    static constexpr float THRESHOLD = 0.5f;
+
+    double sampleRate = 44100.0;
+    int minTau = 2, maxTau = 2;
+    int windowSize = 0, hopSize = 0, span = 0;
+
+    std::vector<float> buffer;          // span + hop samples, window start at index 0
+    std::vector<double> difference;     // d(tau) for tau in [0, maxTau]
+    std::vector<float> normalised;
+    int filled = 0;
+    bool primed = false;
+    int hopsSinceRefresh = 0;
+    int64_t nextSamplePosition = 0;
+};
@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "FlightLogViewer.h"
 
 namespace {
     const char* PLUGIN_VERSION = "v0.24";
@@ -52,6 +53,30 @@ namespace {
     const juce::Colour fretboardCol (38, 32, 26);
     const juce::Colour fretMetal (120, 115, 105);
     const juce::Colour nutBone (220, 215, 200);
+    const juce::Colour chordToneColor (150, 120, 200);
+
+    // Layout
+    const int BAR_HEIGHT = 36;
+    const int DEBUG_PANEL_HEIGHT = 70;
+    const int TUNER_HEIGHT = 70;
+    const int FRET_NUMBER_HEIGHT = 16;
+    const int SPECTROGRAM_HEIGHT = 130;
+    const int NOTE_ROLL_HEIGHT = 110;
+    const double NOTE_ROLL_SECONDS = 6.0;
+
+    // Spectrogram display range
+    const float SPECTROGRAM_MIN_HZ = 40.0f;
+    const float SPECTROGRAM_MAX_HZ = 4000.0f;
+    const float SPECTROGRAM_FLOOR_DB = -100.0f;
+    const float SPECTROGRAM_CEILING_DB = -20.0f;
+
+    // Pitch contour trail length, and how far from the fretted note it is still drawn
+    const double CONTOUR_TRAIL_SECONDS = 0.6;
+    const float CONTOUR_MAX_BEND = 2.5f;
+
+    // Needle easing time constant, and the smallest move worth a repaint
+    const double NEEDLE_SMOOTHING_MS = 60.0;
+    const float NEEDLE_REPAINT_CENTS = 0.05f;
 
     juce::String getNoteName (int midiNote)
     {
@@ -60,11 +85,6 @@ namespace {
         return juce::String (NOTE_NAMES[midiNote % 12]) + juce::String (octave);
     }
 
-    juce::String noteNameOnly (int midiNote)
-    {
-        return juce::String (NOTE_NAMES[midiNote % 12]);
-    }
-
     bool isNoteInScale (int midiNote, int root, int scaleIndex)
     {
         int interval = (midiNote - root + 120) % 12;
@@ -105,7 +125,8 @@ void ModernLookAndFeel::drawComboBox (juce::Graphics& g, int width, int height,
 }
 
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAudioProcessor& p)
-    : AudioProcessorEditor (&p), processorRef (p)
+    : AudioProcessorEditor (&p), processorRef (p),
+      vblankAttachment (this, [this] { onVBlank(); })
 {
     // Apply modern look and feel
     sensitivitySlider.setLookAndFeel (&modernLookAndFeel);
@@ -160,6 +181,10 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
         scaleSelector.addItem (SCALE_NAMES[i], i + 1);
     scaleSelector.setSelectedId (2);  // Default to Major
     addAndMakeVisible (scaleSelector);
+
+    // The fretboard is only repainted when something it shows changes
+    keySelector.onChange = [this] { repaint (getLayout().fretboardRegion); };
+    scaleSelector.onChange = [this] { repaint (getLayout().fretboardRegion); };
     scaleLabel.setText ("SCALE", juce::dontSendNotification);
     scaleLabel.setColour (juce::Label::textColourId, textDim);
     scaleLabel.setFont (juce::Font (10.0f));
@@ -172,6 +197,7 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     positionSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 28, 18);
     positionSlider.setColour (juce::Slider::textBoxTextColourId, textDim);
     positionSlider.setColour (juce::Slider::textBoxOutlineColourId, juce::Colours::transparentBlack);
+    positionSlider.addListener (this);
     addAndMakeVisible (positionSlider);
     positionLabel.setText ("POSITION", juce::dontSendNotification);
     positionLabel.setColour (juce::Label::textColourId, textDim);
@@ -185,6 +211,7 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     rangeSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 28, 18);
     rangeSlider.setColour (juce::Slider::textBoxTextColourId, textDim);
     rangeSlider.setColour (juce::Slider::textBoxOutlineColourId, juce::Colours::transparentBlack);
+    rangeSlider.addListener (this);
     addAndMakeVisible (rangeSlider);
     rangeLabel.setText ("RANGE", juce::dontSendNotification);
     rangeLabel.setColour (juce::Label::textColourId, textDim);
@@ -198,6 +225,7 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     stringsSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 28, 18);
     stringsSlider.setColour (juce::Slider::textBoxTextColourId, textDim);
     stringsSlider.setColour (juce::Slider::textBoxOutlineColourId, juce::Colours::transparentBlack);
+    stringsSlider.addListener (this);
     addAndMakeVisible (stringsSlider);
     stringsLabel.setText ("STRINGS", juce::dontSendNotification);
     stringsLabel.setColour (juce::Label::textColourId, textDim);
@@ -211,6 +239,7 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     fretsSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 28, 18);
     fretsSlider.setColour (juce::Slider::textBoxTextColourId, textDim);
     fretsSlider.setColour (juce::Slider::textBoxOutlineColourId, juce::Colours::transparentBlack);
+    fretsSlider.addListener (this);
     addAndMakeVisible (fretsSlider);
     fretsLabel.setText ("FRETS", juce::dontSendNotification);
     fretsLabel.setColour (juce::Label::textColourId, textDim);
@@ -227,6 +256,17 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     setResizable (true, true);
     setResizeLimits (800, 400, 1600, 700);
     setSize (1000, 480);
+
+    // Spectrogram colour map, dark through blue and green to white
+    juce::ColourGradient heat (bgDark, 0.0f, 0.0f, textBright, 1.0f, 0.0f, false);
+    heat.addColour (0.35, accentBlue.darker (0.6f));
+    heat.addColour (0.7, activeNoteColor);
+    for (int i = 0; i < 256; ++i)
+        spectrogramPalette[i] = heat.getColourAtPosition (i / 255.0).getPixelARGB();
+
+    contourFrames.resize (AudioPluginAudioProcessor::CONTOUR_RING_SIZE / 2);
+
+    // Only feeds the debug log; the tuner runs from the display's vblank
     startTimerHz (15);
 }
 
@@ -236,6 +276,8 @@ void AudioPluginAudioProcessorEditor::sliderValueChanged (juce::Slider* slider)
         processorRef.sensitivityThreshold.store ((float) sensitivitySlider.getValue());
     else if (slider == &holdSlider)
         processorRef.holdTimeMs.store ((int) holdSlider.getValue());
+    else
+        repaint (getLayout().fretboardRegion);
 }
 
 AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor()
@@ -248,6 +290,8 @@ AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor()
     fretsSlider.setLookAndFeel (nullptr);
     keySelector.setLookAndFeel (nullptr);
     scaleSelector.setLookAndFeel (nullptr);
+    processorRef.spectrumEnabled.store (false);
+    processorRef.contourEnabled.store (false);
 }
 
 void AudioPluginAudioProcessorEditor::timerCallback()
@@ -262,7 +306,74 @@ void AudioPluginAudioProcessorEditor::timerCallback()
     if (debugLog.size() > MAX_LOG_SIZE)
         debugLog.pop_front();
 
-    repaint();
+    if (showDebugPanel)
+        repaint (getLayout().debugArea);
+}
+
+void AudioPluginAudioProcessorEditor::onVBlank()
+{
+    if (showSpectrogram && updateSpectrogram())
+        repaint (getLayout().spectrogram);
+
+    if (updateNoteRoll() && showNoteRoll)
+        repaint (getLayout().noteRoll);
+
+    // The contour only changes the active string's band of the fretboard
+    if (showContour)
+    {
+        auto newestPosition = [this]
+        {
+            return numContourFrames > 0 ? contourFrames[(size_t) numContourFrames - 1].samplePosition : (int64_t) -1;
+        };
+
+        const int64_t previousNewest = newestPosition();
+        numContourFrames = processorRef.getRecentContour (contourFrames.data(), (int) contourFrames.size());
+        const int64_t newest = newestPosition();
+
+        int activeString, activeFret;
+        findActivePosition (shownNote, activeString, activeFret, shownString);
+        if (newest != previousNewest && activeString >= 0)
+            repaint (getStringBand (activeString));
+    }
+
+    const double nowMs = juce::Time::getMillisecondCounterHiRes();
+    const double elapsedMs = lastVBlankMs > 0.0 ? juce::jmin (nowMs - lastVBlankMs, 250.0) : 0.0;
+    lastVBlankMs = nowMs;
+
+    const int note = processorRef.detectedMidiNote.load();
+    const float pitch = processorRef.detectedPitch.load();
+    const float targetCents = processorRef.detectedCents.load();
+    const int string = processorRef.detectedString.load();
+    const int calibrating = processorRef.calibratingString.load();
+    const unsigned chordMask = processorRef.detectedChordMask.load();
+    ShowMe::Chord chord;
+    if (chordMask != 0)
+        chord = { processorRef.detectedChordRoot.load(), processorRef.detectedChordType.load(), -1 };
+
+    // Ease the needle towards the latest reading; a fresh note starts where it was detected
+    if (shownNote < 0)
+        needleCents = targetCents;
+    else
+        needleCents += (targetCents - needleCents) * (float) (1.0 - std::exp (-elapsedMs / NEEDLE_SMOOTHING_MS));
+
+    const bool noteChanged = note != shownNote || string != shownString || chordMask != shownChordMask || chord != shownChord;
+    const bool tunerChanged = noteChanged || pitch != shownPitch || calibrating != shownCalibrationString
+                              || std::abs (needleCents - paintedNeedleCents) >= NEEDLE_REPAINT_CENTS;
+    if (! tunerChanged)
+        return;
+
+    const auto layout = getLayout();
+    if (noteChanged)
+        repaint (layout.fretboardRegion);
+    repaint (layout.tuner);
+
+    shownNote = note;
+    shownString = string;
+    shownCalibrationString = calibrating;
+    shownChord = chord;
+    shownChordMask = chordMask;
+    shownPitch = pitch;
+    paintedNeedleCents = needleCents;
 }
 
 void AudioPluginAudioProcessorEditor::showDebugMenu()
@@ -271,6 +382,19 @@ void AudioPluginAudioProcessorEditor::showDebugMenu()
     menu.addItem (1, "Copy debug logs to clipboard");
     menu.addSeparator();
     menu.addItem (2, "Show debug panel", true, showDebugPanel);
+    menu.addItem (3, "Show spectrogram", true, showSpectrogram);
+    menu.addItem (4, "Show pitch contour", true, showContour);
+    menu.addItem (5, "Show note events", true, showNoteRoll);
+    menu.addItem (10, "Recognise chords", true, processorRef.chordsEnabled.load());
+    menu.addSeparator();
+    menu.addItem (8, "Bass mode (long window)", true, processorRef.bassMode.load());
+    if (processorRef.calibratingString.load() >= 0)
+        menu.addItem (9, "Cancel string calibration");
+    else
+        menu.addItem (9, "Calibrate strings...");
+    menu.addSeparator();
+    menu.addItem (6, "Record session", true, processorRef.flightRecorder.isRecording());
+    menu.addItem (7, "Open recording...");
 
     menu.showMenuAsync (juce::PopupMenu::Options().withTargetComponent (&debugButton),
         [this] (int result)
@@ -288,26 +412,434 @@ void AudioPluginAudioProcessorEditor::showDebugMenu()
                 resized();
                 repaint();
             }
+            else if (result == 3)
+            {
+                setSpectrogramVisible (! showSpectrogram);
+            }
+            else if (result == 4)
+            {
+                setContourVisible (! showContour);
+            }
+            else if (result == 5)
+            {
+                setNoteRollVisible (! showNoteRoll);
+            }
+            else if (result == 6)
+            {
+                toggleRecording();
+            }
+            else if (result == 7)
+            {
+                openRecording();
+            }
+            else if (result == 8)
+            {
+                processorRef.bassMode.store (! processorRef.bassMode.load());
+            }
+            else if (result == 10)
+            {
+                processorRef.chordsEnabled.store (! processorRef.chordsEnabled.load());
+            }
+            else if (result == 9)
+            {
+                if (processorRef.calibratingString.load() >= 0)
+                    processorRef.cancelStringCalibration();
+                else
+                    processorRef.startStringCalibration (GUITAR_TUNING, (int) stringsSlider.getValue());
+            }
         });
 }
 
+void AudioPluginAudioProcessorEditor::setSpectrogramVisible (bool shouldBeVisible)
+{
+    showSpectrogram = shouldBeVisible;
+    processorRef.spectrumEnabled.store (shouldBeVisible);
+
+    if (! shouldBeVisible)
+        spectrogramImage = {};
+
+    resized();
+    repaint();
+}
+
+void AudioPluginAudioProcessorEditor::prepareSpectrogram (juce::Rectangle<int> area, double sampleRate)
+{
+    const int w = area.getWidth();
+    const int h = area.getHeight();
+    if (w <= 0 || h <= 0 || sampleRate <= 0.0)
+    {
+        spectrogramImage = {};
+        return;
+    }
+
+    // Software image so writing a column never round-trips through a native surface
+    if (spectrogramImage.getWidth() != w || spectrogramImage.getHeight() != h)
+    {
+        spectrogramImage = juce::Image (juce::Image::ARGB, w, h, false, juce::SoftwareImageType());
+        spectrogramImage.clear (spectrogramImage.getBounds(), bgDark);
+        spectrogramWriteX = 0;
+    }
+
+    if (sampleRate == spectrogramSampleRate && (int) spectrogramRowBinLo.size() == h)
+        return;
+
+    // Log-frequency rows, highest at the top; each row takes the loudest FFT bin it spans
+    spectrogramSampleRate = sampleRate;
+    spectrogramRowBinLo.resize ((size_t) h);
+    spectrogramRowBinHi.resize ((size_t) h);
+
+    const double binHz = sampleRate / (double) (1 << AudioPluginAudioProcessor::FFT_ORDER);
+    const double ratio = SPECTROGRAM_MAX_HZ / SPECTROGRAM_MIN_HZ;
+    for (int row = 0; row < h; ++row)
+    {
+        const double hiHz = SPECTROGRAM_MIN_HZ * std::pow (ratio, 1.0 - (double) row / h);
+        const double loHz = SPECTROGRAM_MIN_HZ * std::pow (ratio, 1.0 - (double) (row + 1) / h);
+        const int lo = juce::jlimit (0, AudioPluginAudioProcessor::SPECTRUM_BINS - 1, (int) std::floor (loHz / binHz));
+        const int hi = juce::jlimit (lo + 1, AudioPluginAudioProcessor::SPECTRUM_BINS, (int) std::ceil (hiHz / binHz));
+        spectrogramRowBinLo[(size_t) row] = lo;
+        spectrogramRowBinHi[(size_t) row] = hi;
+    }
+}
+
+bool AudioPluginAudioProcessorEditor::updateSpectrogram()
+{
+    const double sampleRate = processorRef.getSampleRate();
+    if (sampleRate != spectrogramSampleRate)
+        prepareSpectrogram (getLayout().spectrogram, sampleRate);
+
+    bool wroteAny = false;
+    while (processorRef.popSpectrumFrame (spectrumFrame))
+    {
+        if (spectrogramImage.isValid())
+        {
+            writeSpectrogramColumn (spectrumFrame);
+            wroteAny = true;
+        }
+    }
+    return wroteAny;
+}
+
+void AudioPluginAudioProcessorEditor::writeSpectrogramColumn (const AudioPluginAudioProcessor::SpectrumFrame& frame)
+{
+    const int h = spectrogramImage.getHeight();
+    juce::Image::BitmapData column (spectrogramImage, spectrogramWriteX, 0, 1, h, juce::Image::BitmapData::writeOnly);
+
+    const float dbRange = SPECTROGRAM_CEILING_DB - SPECTROGRAM_FLOOR_DB;
+    for (int row = 0; row < h; ++row)
+    {
+        float peak = SPECTROGRAM_FLOOR_DB;
+        for (int bin = spectrogramRowBinLo[(size_t) row]; bin < spectrogramRowBinHi[(size_t) row]; ++bin)
+            peak = juce::jmax (peak, frame.magnitudeDb[bin]);
+
+        const int level = juce::jlimit (0, 255, (int) ((peak - SPECTROGRAM_FLOOR_DB) * 255.0f / dbRange));
+        *reinterpret_cast<juce::PixelARGB*> (column.getPixelPointer (0, row)) = spectrogramPalette[level];
+    }
+
+    // Pitch trail
+    if (frame.pitch >= SPECTROGRAM_MIN_HZ && frame.pitch < SPECTROGRAM_MAX_HZ)
+    {
+        const float position = std::log (frame.pitch / SPECTROGRAM_MIN_HZ) / std::log (SPECTROGRAM_MAX_HZ / SPECTROGRAM_MIN_HZ);
+        const int row = juce::jlimit (0, h - 2, (int) ((1.0f - position) * h));
+        const auto trail = rootNoteColor.brighter (0.5f).getPixelARGB();
+        *reinterpret_cast<juce::PixelARGB*> (column.getPixelPointer (0, row)) = trail;
+        *reinterpret_cast<juce::PixelARGB*> (column.getPixelPointer (0, row + 1)) = trail;
+    }
+
+    spectrogramWriteX = (spectrogramWriteX + 1) % spectrogramImage.getWidth();
+}
+
+void AudioPluginAudioProcessorEditor::drawSpectrogram (juce::Graphics& g, juce::Rectangle<int> area)
+{
+    if (! spectrogramImage.isValid() || spectrogramImage.getBounds() != area.withZeroOrigin())
+    {
+        g.setColour (bgDark);
+        g.fillRect (area);
+        return;
+    }
+
+    // Oldest columns (right of the write head) go on the left, newest end at the right edge
+    const int h = area.getHeight();
+    const int older = spectrogramImage.getWidth() - spectrogramWriteX;
+    g.drawImage (spectrogramImage, area.getX(), area.getY(), older, h, spectrogramWriteX, 0, older, h);
+    if (spectrogramWriteX > 0)
+        g.drawImage (spectrogramImage, area.getX() + older, area.getY(), spectrogramWriteX, h, 0, 0, spectrogramWriteX, h);
+
+    // Frequency guides
+    g.setFont (juce::Font (9.0f));
+    const float ratio = std::log (SPECTROGRAM_MAX_HZ / SPECTROGRAM_MIN_HZ);
+    for (float hz : { 100.0f, 200.0f, 500.0f, 1000.0f, 2000.0f })
+    {
+        const int y = area.getY() + (int) ((1.0f - std::log (hz / SPECTROGRAM_MIN_HZ) / ratio) * h);
+        g.setColour (textDim.withAlpha (0.3f));
+        g.drawHorizontalLine (y, (float) area.getX(), (float) area.getRight());
+        g.setColour (textDim);
+        g.drawText (hz >= 1000.0f ? juce::String ((int) hz / 1000) + "k" : juce::String ((int) hz),
+                    area.getX() + 2, y - 11, 30, 10, juce::Justification::bottomLeft);
+    }
+}
+
+void AudioPluginAudioProcessorEditor::setContourVisible (bool shouldBeVisible)
+{
+    showContour = shouldBeVisible;
+    processorRef.contourEnabled.store (shouldBeVisible);
+    numContourFrames = 0;
+    repaint (getLayout().fretboardRegion);
+}
+
+juce::Rectangle<int> AudioPluginAudioProcessorEditor::getStringBand (int stringIndex) const
+{
+    const auto fretboard = getLayout().fretboard;
+    const float stringSpacing = (float) fretboard.getHeight() / ((int) stringsSlider.getValue() + 1);
+    const float y = fretboard.getY() + (stringIndex + 1) * stringSpacing;
+
+    // Room for the trail below the string and the bend label above it
+    return juce::Rectangle<float> ((float) fretboard.getX(), y - stringSpacing * 0.5f - 14.0f,
+                                   (float) fretboard.getWidth(), stringSpacing + 28.0f).getSmallestIntegerContainer();
+}
+
+void AudioPluginAudioProcessorEditor::drawContour (juce::Graphics& g, juce::Rectangle<int> area, int activeString, int activeFret)
+{
+    if (numContourFrames == 0)
+        return;
+
+    const int numStrings = (int) stringsSlider.getValue();
+    const int numFrets = (int) fretsSlider.getValue();
+    const float fretWidth = (float) area.getWidth() / (numFrets + 1);
+    const float stringSpacing = (float) area.getHeight() / (numStrings + 1);
+    const float stringY = area.getY() + (activeString + 1) * stringSpacing;
+    const int openNote = GUITAR_TUNING[activeString];
+
+    const double sampleRate = processorRef.getSampleRate();
+    const float threshold = processorRef.sensitivityThreshold.load();
+    const int64_t newest = contourFrames[(size_t) numContourFrames - 1].samplePosition;
+
+    // Fractional fret position along the active string, or -1 when the frame has no usable pitch
+    auto fretFor = [&] (const AudioPluginAudioProcessor::ContourFrame& frame)
+    {
+        if (frame.pitch <= 0.0f || frame.confidence < threshold)
+            return -1.0f;
+        const float fret = 69.0f + 12.0f * std::log2 (frame.pitch / 440.0f) - openNote;
+        return std::abs (fret - activeFret) <= CONTOUR_MAX_BEND ? fret : -1.0f;
+    };
+
+    // Trail: recent positions sink below the string as they age
+    juce::Path trail;
+    bool penDown = false;
+    for (int i = 0; i < numContourFrames; ++i)
+    {
+        const auto& frame = contourFrames[(size_t) i];
+        const double age = (double) (newest - frame.samplePosition) / sampleRate;
+        const float fret = fretFor (frame);
+        if (age > CONTOUR_TRAIL_SECONDS || fret < 0.0f)
+        {
+            penDown = false;
+            continue;
+        }
+
+        const float x = area.getX() + (fret + 0.5f) * fretWidth;
+        const float y = stringY + (float) (age / CONTOUR_TRAIL_SECONDS) * stringSpacing * 0.45f;
+        if (penDown)
+            trail.lineTo (x, y);
+        else
+            trail.startNewSubPath (x, y);
+        penDown = true;
+    }
+
+    g.setColour (activeNoteColor.withAlpha (0.7f));
+    g.strokePath (trail, juce::PathStrokeType (2.0f, juce::PathStrokeType::curved, juce::PathStrokeType::rounded));
+
+    // Bend indicator: how far the newest pitch sits from the fretted note
+    const float fret = fretFor (contourFrames[(size_t) numContourFrames - 1]);
+    if (fret < 0.0f)
+        return;
+
+    const float bendCents = (fret - activeFret) * 100.0f;
+    const float fretX = area.getX() + (activeFret + 0.5f) * fretWidth;
+    const float x = area.getX() + (fret + 0.5f) * fretWidth;
+    const auto colour = bendCents < -5.0f ? flatColor : (bendCents > 5.0f ? sharpColor : activeNoteColor);
+
+    g.setColour (colour.withAlpha (0.8f));
+    g.drawLine (fretX, stringY, x, stringY, 3.0f);
+    g.fillEllipse (x - 5.0f, stringY - 5.0f, 10.0f, 10.0f);
+
+    if (std::abs (bendCents) >= 5.0f)
+    {
+        g.setFont (juce::Font (10.0f, juce::Font::bold));
+        g.drawText ((bendCents > 0.0f ? "+" : "") + juce::String (juce::roundToInt (bendCents)) + "c",
+                    juce::Rectangle<float> (x - 20.0f, stringY - 24.0f, 40.0f, 12.0f), juce::Justification::centred);
+    }
+}
+
+void AudioPluginAudioProcessorEditor::setNoteRollVisible (bool shouldBeVisible)
+{
+    showNoteRoll = shouldBeVisible;
+    resized();
+    repaint();
+}
+
+bool AudioPluginAudioProcessorEditor::updateNoteRoll()
+{
+    // Always drained so the roll is current whenever it is opened
+    bool changed = false;
+    AudioPluginAudioProcessor::NoteEvent event;
+    while (processorRef.popNoteEvent (event))
+    {
+        changed = true;
+        if (event.type == AudioPluginAudioProcessor::NoteEvent::noteStarted)
+        {
+            rollNotes[rollNext] = { event.midiNote, event.onsetSample, -1 };
+            rollNext = (rollNext + 1) % ROLL_CAPACITY;
+            continue;
+        }
+
+        for (int i = 1; i <= ROLL_CAPACITY; ++i)
+        {
+            auto& note = rollNotes[(rollNext - i + ROLL_CAPACITY) % ROLL_CAPACITY];
+            if (note.onsetSample == event.onsetSample && note.midiNote == event.midiNote)
+            {
+                note.offsetSample = event.offsetSample;
+                break;
+            }
+        }
+    }
+
+    // The roll scrolls, so it needs a frame while any note is still on screen
+    const int64_t oldest = processorRef.totalSamplesWritten.load()
+                           - (int64_t) (NOTE_ROLL_SECONDS * processorRef.getSampleRate());
+    for (const auto& note : rollNotes)
+        if (note.midiNote >= 0 && (note.offsetSample < 0 || note.offsetSample > oldest))
+            return true;
+
+    return changed;
+}
+
+void AudioPluginAudioProcessorEditor::drawNoteRoll (juce::Graphics& g, juce::Rectangle<int> area)
+{
+    g.setColour (panelBg);
+    g.fillRoundedRectangle (area.toFloat(), 4.0f);
+
+    const double sampleRate = processorRef.getSampleRate();
+    if (sampleRate <= 0.0)
+        return;
+
+    // Pitch axis covers the instrument as configured
+    const int numStrings = (int) stringsSlider.getValue();
+    const int lowest = GUITAR_TUNING[numStrings - 1];
+    const int highest = GUITAR_TUNING[0] + (int) fretsSlider.getValue();
+    const float rowHeight = (float) area.getHeight() / (highest - lowest + 1);
+
+    g.setFont (juce::Font (9.0f));
+    for (int n = lowest; n <= highest; ++n)
+    {
+        if (n % 12 != 0)
+            continue;
+        const float y = area.getBottom() - (n - lowest + 1) * rowHeight;
+        g.setColour (controlBorder);
+        g.drawHorizontalLine ((int) y, (float) area.getX(), (float) area.getRight());
+        g.setColour (textDim);
+        g.drawText (getNoteName (n), area.getX() + 2, (int) y, 30, 10, juce::Justification::topLeft);
+    }
+
+    const int64_t now = processorRef.totalSamplesWritten.load();
+    const float pixelsPerSample = (float) (area.getWidth() / (NOTE_ROLL_SECONDS * sampleRate));
+    auto xFor = [&] (int64_t sample) { return (float) area.getRight() - (float) (now - sample) * pixelsPerSample; };
+
+    for (const auto& note : rollNotes)
+    {
+        if (note.midiNote < lowest || note.midiNote > highest)
+            continue;
+
+        const bool sounding = note.offsetSample < 0;
+        const float x0 = juce::jmax ((float) area.getX(), xFor (note.onsetSample));
+        const float x1 = sounding ? (float) area.getRight() : xFor (note.offsetSample);
+        if (x1 <= area.getX())
+            continue;
+
+        const float y = area.getBottom() - (note.midiNote - lowest + 1) * rowHeight;
+        const juce::Rectangle<float> bar (x0, y, juce::jmax (2.0f, x1 - x0), juce::jmax (2.0f, rowHeight));
+        g.setColour (sounding ? activeNoteColor : scaleNoteColor);
+        g.fillRoundedRectangle (bar, 2.0f);
+
+        // Tab position for the note, as the fretboard would show it
+        int string, fret;
+        findActivePosition (note.midiNote, string, fret);
+        const juce::String label = getNoteName (note.midiNote) + (string >= 0 ? " " + juce::String (fret) : juce::String());
+        if (bar.getWidth() > 34.0f)
+        {
+            g.setColour (sounding ? bgDark : textBright);
+            g.drawText (label, bar.withHeight (juce::jmax (10.0f, rowHeight)).reduced (3.0f, 0.0f),
+                        juce::Justification::centredLeft, false);
+        }
+    }
+}
+
 void AudioPluginAudioProcessorEditor::copyLogToClipboard()
 {
-    juce::String log;
-    log += "=== Show Me Audio Debug Log ===\n";
-    log += "Sample Rate: " + juce::String(processorRef.getSampleRate()) + " Hz\n";
-    log += "Samples: " + juce::String((int)debugLog.size()) + "\n\n";
-    log += "RMS,Pitch,Confidence,DisplayedNote\n";
-
-    for (const auto& s : debugLog)
-    {
-        log += juce::String(s.rms, 8) + ",";
-        log += juce::String(s.pitch, 1) + ",";
-        log += juce::String(s.confidence, 3) + ",";
-        log += juce::String(s.displayedNote) + "\n";
+    // Formatted line by line into one preallocated buffer
+    juce::MemoryOutputStream out;
+    out.preallocate (256 + debugLog.size() * 48);
+
+    char line[128];
+    auto writeLine = [&out, &line] (int length) { out.write (line, (size_t) juce::jlimit (0, (int) sizeof (line) - 1, length)); };
+
+    writeLine (std::snprintf (line, sizeof (line), "=== Show Me Audio Debug Log ===\nSample Rate: %g Hz\nSamples: %d\n\n",
+                              processorRef.getSampleRate(), (int) debugLog.size()));
+    writeLine (std::snprintf (line, sizeof (line), "RMS,Pitch,Confidence,DisplayedNote\n"));
+
+    for (const auto& sample : debugLog)
+        writeLine (std::snprintf (line, sizeof (line), "%.8f,%.1f,%.3f,%d\n",
+                                  sample.rms, sample.pitch, sample.confidence, sample.displayedNote));
+
+    juce::SystemClipboard::copyTextToClipboard (out.toString());
+}
+
+void AudioPluginAudioProcessorEditor::toggleRecording()
+{
+    auto& recorder = processorRef.flightRecorder;
+    if (recorder.isRecording())
+    {
+        recorder.stop();
+        return;
     }
 
-    juce::SystemClipboard::copyTextToClipboard(log);
+    const auto error = recorder.start (FlightRecorder::createSessionDirectory(), processorRef.getSampleRate());
+    if (error.isNotEmpty())
+        juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon, "Flight recorder", error);
+}
+
+void AudioPluginAudioProcessorEditor::openRecording()
+{
+    auto start = processorRef.flightRecorder.getSessionDirectory();
+    if (! start.isDirectory())
+        start = FlightRecorder::getDefaultRecordingsDirectory();
+
+    recordingChooser = std::make_unique<juce::FileChooser> ("Open a recorded session", start);
+    recordingChooser->launchAsync (juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectDirectories,
+        [] (const juce::FileChooser& fc)
+        {
+            const auto dir = fc.getResult();
+            if (dir == juce::File())
+                return;
+
+            auto log = std::make_unique<FlightLog>();
+            const auto error = log->open (dir);
+            if (error.isNotEmpty())
+            {
+                juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon, "Flight recorder", error);
+                return;
+            }
+
+            // The viewer owns the log and lives in its own window, independent of the editor
+            juce::DialogWindow::LaunchOptions options;
+            auto* viewer = new FlightLogViewer (std::move (log));
+            viewer->setSize (900, 420);
+            options.content.setOwned (viewer);
+            options.dialogTitle = "Flight recorder - " + dir.getFileName();
+            options.dialogBackgroundColour = bgDark;
+            options.resizable = true;
+            options.useNativeTitleBar = true;
+            options.launchAsync();
+        });
 }
 
 void AudioPluginAudioProcessorEditor::drawTuner (juce::Graphics& g, juce::Rectangle<int> area, int midiNote, float pitch, float cents)
@@ -319,7 +851,18 @@ void AudioPluginAudioProcessorEditor::drawTuner (juce::Graphics& g, juce::Rectan
 
     // Note name - large on left
     auto noteArea = tunerArea.removeFromLeft (100);
-    if (midiNote >= 0)
+    auto freqArea = tunerArea.removeFromLeft (100);
+
+    // A strummed chord is named in place of the single note and its frequency
+    if (shownChord.isValid())
+    {
+        char name[24];
+        ShowMe::formatChord (shownChord, name, (int) sizeof (name));
+        g.setColour (chordToneColor);
+        g.setFont (juce::Font (40.0f, juce::Font::bold));
+        g.drawFittedText (name, noteArea.getUnion (freqArea), juce::Justification::centred, 1);
+    }
+    else if (midiNote >= 0)
     {
         g.setColour (activeNoteColor);
         g.setFont (juce::Font (48.0f, juce::Font::bold));
@@ -327,14 +870,24 @@ void AudioPluginAudioProcessorEditor::drawTuner (juce::Graphics& g, juce::Rectan
     }
 
     // Frequency
-    auto freqArea = tunerArea.removeFromLeft (100);
-    if (pitch > 0.0f)
+    if (pitch > 0.0f && ! shownChord.isValid())
     {
         g.setColour (textBright);
         g.setFont (18.0f);
         g.drawText (juce::String (pitch, 2) + " Hz", freqArea, juce::Justification::centred);
     }
 
+    // While calibrating, the cents bar gives way to the string to pluck next
+    if (shownCalibrationString >= 0)
+    {
+        g.setColour (accentBlue);
+        g.setFont (16.0f);
+        g.drawText ("Calibrating: pluck the open " + getNoteName (GUITAR_TUNING[shownCalibrationString])
+                        + " string (" + juce::String (shownCalibrationString + 1) + ") and let it ring",
+                    tunerArea, juce::Justification::centred);
+        return;
+    }
+
     // Cents bar
     auto centsBarArea = tunerArea.reduced (20, 15);
     float barHeight = 16.0f;
@@ -367,6 +920,53 @@ void AudioPluginAudioProcessorEditor::drawTuner (juce::Graphics& g, juce::Rectan
     }
 }
 
+void AudioPluginAudioProcessorEditor::findActivePosition (int midiNote, int& activeString, int& activeFret, int playedString) const
+{
+    const int position = (int) positionSlider.getValue();
+    const int range = (int) rangeSlider.getValue();
+    const int numStrings = (int) stringsSlider.getValue();
+    const int numFrets = (int) fretsSlider.getValue();
+
+    activeString = -1;
+    activeFret = -1;
+
+    // The string the note was identified on wins when the fretboard has it
+    if (midiNote >= 0 && playedString >= 0 && playedString < numStrings)
+    {
+        const int fret = midiNote - GUITAR_TUNING[playedString];
+        if (fret >= 0 && fret <= numFrets)
+        {
+            activeString = playedString;
+            activeFret = fret;
+            return;
+        }
+    }
+
+    if (midiNote >= 0)
+    {
+        // Find the best position for this note
+        for (int s = 0; s < numStrings; ++s)
+        {
+            int fret = midiNote - GUITAR_TUNING[s];
+            if (fret >= 0 && fret <= numFrets)
+            {
+                // Prefer positions in the current zone
+                if (fret >= position && fret <= position + range - 1)
+                {
+                    activeString = s;
+                    activeFret = fret;
+                    break;
+                }
+                else if (activeString < 0)
+                {
+                    activeString = s;
+                    activeFret = fret;
+                }
+            }
+        }
+    }
+}
+
 void AudioPluginAudioProcessorEditor::drawFretboard (juce::Graphics& g, juce::Rectangle<int> area, int midiNote)
 {
     const int position = (int) positionSlider.getValue();
@@ -409,36 +1009,28 @@ void AudioPluginAudioProcessorEditor::drawFretboard (juce::Graphics& g, juce::Re
         g.drawLine (x, (float) area.getY(), x, (float) area.getBottom(), 1.0f);
     }
 
-    // Find where the detected note would be on the fretboard
-    int activeString = -1, activeFret = -1;
-    if (midiNote >= 0)
-    {
-        // Find the best position for this note
-        for (int s = 0; s < numStrings; ++s)
-        {
-            int fret = midiNote - GUITAR_TUNING[s];
-            if (fret >= 0 && fret <= numFrets)
-            {
-                // Prefer positions in the current zone
-                if (fret >= position && fret <= position + range - 1)
-                {
-                    activeString = s;
-                    activeFret = fret;
-                    break;
-                }
-                else if (activeString < 0)
-                {
-                    activeString = s;
-                    activeFret = fret;
-                }
-            }
-        }
-    }
+    // Find where the detected note would be on the fretboard, on its string when identified
+    int activeString, activeFret;
+    findActivePosition (midiNote, activeString, activeFret, shownString);
 
-    // Draw notes - bigger and more visible
+    // Draw notes - bigger and more visible, blitted from the pre-rendered atlas
     float noteW = juce::jmin (fretWidth * 0.85f, 32.0f);
     float noteH = juce::jmin (stringSpacing * 0.75f, 26.0f);
-    g.setFont (11.0f);
+
+    NoteLabelAtlas::Params atlasParams;
+    atlasParams.cellWidth = noteW;
+    atlasParams.cellHeight = noteH;
+    atlasParams.fontHeight = 11.0f;
+    atlasParams.cornerSize = 3.0f;
+    atlasParams.glowMargin = 4.0f;
+    atlasParams.glowCornerSize = 5.0f;
+    atlasParams.pixelScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    atlasParams.styles[NoteLabelAtlas::active]     = { activeNoteColor, bgDark };
+    atlasParams.styles[NoteLabelAtlas::root]       = { rootNoteColor, textBright };
+    atlasParams.styles[NoteLabelAtlas::inScale]    = { scaleNoteColor, textBright };
+    atlasParams.styles[NoteLabelAtlas::outOfScale] = { outOfScaleColor, textDim.withAlpha (0.5f) };
+    atlasParams.styles[NoteLabelAtlas::chordTone]  = { chordToneColor, textBright };
+    noteAtlas.prepare (atlasParams);
 
     for (int s = 0; s < numStrings; ++s)
     {
@@ -451,42 +1043,23 @@ void AudioPluginAudioProcessorEditor::drawFretboard (juce::Graphics& g, juce::Re
             float x = area.getX() + (f + 0.5f) * fretWidth;
             int noteClass = midi % 12;
 
-            bool isActive = (s == activeString && f == activeFret);
-            bool isRoot = (noteClass == key);
-            bool inScale = isNoteInScale (midi, key, scale);
-
-            juce::Colour bg, fg;
-            if (isActive) {
-                bg = activeNoteColor;
-                fg = bgDark;
-            } else if (isRoot) {
-                bg = rootNoteColor;
-                fg = textBright;
-            } else if (inScale) {
-                bg = scaleNoteColor;
-                fg = textBright;
-            } else {
-                bg = outOfScaleColor;
-                fg = textDim.withAlpha (0.5f);
-            }
-
-            juce::Rectangle<float> noteRect (x - noteW/2, y - noteH/2, noteW, noteH);
-
-            // Glow for active note
-            if (isActive)
-            {
-                g.setColour (activeNoteColor.withAlpha (0.4f));
-                g.fillRoundedRectangle (noteRect.expanded (4), 5.0f);
-            }
-
-            g.setColour (bg);
-            g.fillRoundedRectangle (noteRect, 3.0f);
-
-            g.setColour (fg);
-            g.drawText (noteNameOnly (midi), noteRect, juce::Justification::centred, false);
+            auto state = NoteLabelAtlas::outOfScale;
+            if (s == activeString && f == activeFret)
+                state = NoteLabelAtlas::active;
+            else if (shownChordMask & (1u << noteClass))
+                state = NoteLabelAtlas::chordTone;
+            else if (noteClass == key)
+                state = NoteLabelAtlas::root;
+            else if (isNoteInScale (midi, key, scale))
+                state = NoteLabelAtlas::inScale;
+
+            noteAtlas.draw (g, noteClass, state, { x - noteW/2, y - noteH/2, noteW, noteH });
         }
     }
 
+    if (showContour && activeString >= 0)
+        drawContour (g, area, activeString, activeFret);
+
     // Fret numbers - all frets, traditional markers highlighted
     // Traditional dot marker positions: 3, 5, 7, 9, 12 (double), 15, 17, 19, 21, 24 (double)
     auto isMarkerFret = [](int f) {
@@ -515,43 +1088,70 @@ void AudioPluginAudioProcessorEditor::drawFretboard (juce::Graphics& g, juce::Re
     }
 }
 
+AudioPluginAudioProcessorEditor::Layout AudioPluginAudioProcessorEditor::getLayout() const
+{
+    Layout layout;
+    auto bounds = getLocalBounds();
+
+    layout.topBar = bounds.removeFromTop (BAR_HEIGHT);
+    layout.bottomBar = bounds.removeFromBottom (BAR_HEIGHT);
+    if (showDebugPanel)
+        layout.debugArea = bounds.removeFromBottom (DEBUG_PANEL_HEIGHT).reduced (10, 5);
+    if (showSpectrogram)
+        layout.spectrogram = bounds.removeFromBottom (SPECTROGRAM_HEIGHT).reduced (10, 5);
+    if (showNoteRoll)
+        layout.noteRoll = bounds.removeFromBottom (NOTE_ROLL_HEIGHT).reduced (10, 5);
+
+    // Main content area
+    bounds = bounds.reduced (10, 5);
+    layout.tuner = bounds.removeFromTop (TUNER_HEIGHT);
+    bounds.removeFromTop (5);
+
+    // The region includes the fret numbers drawn above and below the board
+    layout.fretboardRegion = bounds;
+    layout.fretboard = bounds.reduced (0, 5);
+    layout.fretboard.removeFromBottom (FRET_NUMBER_HEIGHT);
+    return layout;
+}
+
 void AudioPluginAudioProcessorEditor::paint (juce::Graphics& g)
 {
     g.fillAll (bgDark);
 
-    float pitch = processorRef.detectedPitch.load();
-    float cents = processorRef.detectedCents.load();
-    int midiNote = processorRef.detectedMidiNote.load();
-
-    auto bounds = getLocalBounds();
+    const auto layout = getLayout();
 
     // Top control bar area
-    auto topBar = bounds.removeFromTop (36);
-    g.setColour (panelBg);
-    g.fillRect (topBar);
-    g.setColour (controlBorder);
-    g.drawHorizontalLine (topBar.getBottom() - 1, 0.0f, (float) getWidth());
-
-    // Draw "Billions of Notes" branding and version on the right of top bar
-    auto brandArea = topBar.removeFromRight (220).reduced (10, 0);
-    g.setColour (activeNoteColor);
-    g.setFont (juce::Font (16.0f, juce::Font::bold));
-    g.drawText (PLUGIN_TITLE, brandArea.removeFromLeft (160), juce::Justification::centredRight);
-    g.setColour (textDim);
-    g.setFont (juce::Font (11.0f));
-    g.drawText (PLUGIN_VERSION, brandArea, juce::Justification::centredLeft);
+    if (g.clipRegionIntersects (layout.topBar))
+    {
+        auto topBar = layout.topBar;
+        g.setColour (panelBg);
+        g.fillRect (topBar);
+        g.setColour (controlBorder);
+        g.drawHorizontalLine (topBar.getBottom() - 1, 0.0f, (float) getWidth());
+
+        // Draw "Billions of Notes" branding and version on the right of top bar
+        auto brandArea = topBar.removeFromRight (220).reduced (10, 0);
+        g.setColour (activeNoteColor);
+        g.setFont (juce::Font (16.0f, juce::Font::bold));
+        g.drawText (PLUGIN_TITLE, brandArea.removeFromLeft (160), juce::Justification::centredRight);
+        g.setColour (textDim);
+        g.setFont (juce::Font (11.0f));
+        g.drawText (PLUGIN_VERSION, brandArea, juce::Justification::centredLeft);
+    }
 
     // Bottom control bar
-    auto bottomBar = bounds.removeFromBottom (36);
-    g.setColour (panelBg);
-    g.fillRect (bottomBar);
-    g.setColour (controlBorder);
-    g.drawHorizontalLine (bottomBar.getY(), 0.0f, (float) getWidth());
+    if (g.clipRegionIntersects (layout.bottomBar))
+    {
+        g.setColour (panelBg);
+        g.fillRect (layout.bottomBar);
+        g.setColour (controlBorder);
+        g.drawHorizontalLine (layout.bottomBar.getY(), 0.0f, (float) getWidth());
+    }
 
     // Debug panel if enabled
-    if (showDebugPanel)
+    if (showDebugPanel && g.clipRegionIntersects (layout.debugArea))
     {
-        auto debugArea = bounds.removeFromBottom (70).reduced (10, 5);
+        auto debugArea = layout.debugArea;
         g.setColour (juce::Colour(30, 30, 35));
         g.fillRoundedRectangle (debugArea.toFloat(), 4.0f);
 
@@ -572,28 +1172,27 @@ void AudioPluginAudioProcessorEditor::paint (juce::Graphics& g)
         g.drawText (juce::String(debugStr), debugTextArea, juce::Justification::centred);
     }
 
-    // Main content area
-    bounds = bounds.reduced (10, 5);
+    if (showSpectrogram && g.clipRegionIntersects (layout.spectrogram))
+        drawSpectrogram (g, layout.spectrogram);
 
-    // Tuner area at top
-    auto tunerArea = bounds.removeFromTop (70);
-    drawTuner (g, tunerArea, midiNote, pitch, cents);
+    if (showNoteRoll && g.clipRegionIntersects (layout.noteRoll))
+        drawNoteRoll (g, layout.noteRoll);
 
-    bounds.removeFromTop (5);
+    // Tuner area at top
+    if (g.clipRegionIntersects (layout.tuner))
+        drawTuner (g, layout.tuner, shownNote, shownPitch, needleCents);
 
     // Fretboard area
-    auto fretArea = bounds.reduced (0, 5);
-    fretArea.removeFromBottom (16);  // Space for fret numbers
-    drawFretboard (g, fretArea, midiNote);
-
+    if (g.clipRegionIntersects (layout.fretboardRegion))
+        drawFretboard (g, layout.fretboard, shownNote);
 }
 
 void AudioPluginAudioProcessorEditor::resized()
 {
-    auto bounds = getLocalBounds();
+    const auto layout = getLayout();
 
     // Top control bar
-    auto topBar = bounds.removeFromTop (36).reduced (10, 6);
+    auto topBar = layout.topBar.reduced (10, 6);
 
     int x = topBar.getX();
     int y = topBar.getY();
@@ -610,7 +1209,7 @@ void AudioPluginAudioProcessorEditor::resized()
     scaleSelector.setBounds (x, y, 130, h);
 
     // Bottom control bar
-    auto bottomBar = bounds.removeFromBottom (36).reduced (10, 6);
+    auto bottomBar = layout.bottomBar.reduced (10, 6);
 
     x = bottomBar.getX();
     y = bottomBar.getY();
@@ -639,13 +1238,13 @@ void AudioPluginAudioProcessorEditor::resized()
     // Debug button on the right
     debugButton.setBounds (bottomBar.removeFromRight (60));
 
+    if (showSpectrogram)
+        prepareSpectrogram (layout.spectrogram, processorRef.getSampleRate());
+
     // Debug panel controls (SENS, HOLD) - positioned in debug area when visible
     if (showDebugPanel)
     {
-        auto debugBounds = getLocalBounds();
-        debugBounds.removeFromTop (36);    // Top bar
-        debugBounds.removeFromBottom (36); // Bottom bar
-        auto debugArea = debugBounds.removeFromBottom (70).reduced (15, 10);
+        auto debugArea = layout.debugArea.reduced (5, 5);
         auto controlRow = debugArea.removeFromTop (28);
 
         int dx = controlRow.getX();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include "../../Source/NoteLabelAtlas.h"
 #include <deque>
 
 // Modern slider look and feel
@@ -94,12 +95,40 @@ public:
     void resized() override;
 
 private:
+    // Editor regions, shared by paint, resized and the partial repaints
+    struct Layout
+    {
+        juce::Rectangle<int> topBar, bottomBar, debugArea, spectrogram, noteRoll, tuner, fretboard, fretboardRegion;
+    };
+    Layout getLayout() const;
+
     void timerCallback() override;
+    void onVBlank();
     void sliderValueChanged (juce::Slider* slider) override;
     void copyLogToClipboard();
+    void toggleRecording();
+    void openRecording();
     void showDebugMenu();
     void drawTuner (juce::Graphics& g, juce::Rectangle<int> area, int midiNote, float pitch, float cents);
     void drawFretboard (juce::Graphics& g, juce::Rectangle<int> area, int midiNote);
+    void findActivePosition (int midiNote, int& activeString, int& activeFret, int playedString = -1) const;
+
+    // Pitch contour overlay
+    void setContourVisible (bool shouldBeVisible);
+    juce::Rectangle<int> getStringBand (int stringIndex) const;
+    void drawContour (juce::Graphics& g, juce::Rectangle<int> area, int activeString, int activeFret);
+
+    // Note event piano roll
+    void setNoteRollVisible (bool shouldBeVisible);
+    bool updateNoteRoll();
+    void drawNoteRoll (juce::Graphics& g, juce::Rectangle<int> area);
+
+    // Spectrogram panel
+    void setSpectrogramVisible (bool shouldBeVisible);
+    void prepareSpectrogram (juce::Rectangle<int> area, double sampleRate);
+    bool updateSpectrogram();
+    void writeSpectrogramColumn (const AudioPluginAudioProcessor::SpectrumFrame& frame);
+    void drawSpectrogram (juce::Graphics& g, juce::Rectangle<int> area);
 
     AudioPluginAudioProcessor& processorRef;
 
@@ -123,9 +152,13 @@ private:
     juce::Label keyLabel, scaleLabel, positionLabel, rangeLabel, stringsLabel, fretsLabel;
     juce::Label sensLabel, holdLabel;
 
+    // Pre-rendered fretboard note cells
+    NoteLabelAtlas noteAtlas;
+
     // Debug button
     juce::TextButton debugButton;
     bool showDebugPanel = false;
+    std::unique_ptr<juce::FileChooser> recordingChooser;
 
     // Debug log - stores last N samples
     struct DebugSample {
@@ -137,5 +170,47 @@ private:
     std::deque<DebugSample> debugLog;
     static constexpr int MAX_LOG_SIZE = 100;  // ~10 seconds at 10fps
 
+    // Spectrogram history lives in a circular image: each analysis frame overwrites one
+    // column at spectrogramWriteX, and paint blits the two halves oldest-first
+    bool showSpectrogram = false;
+    juce::Image spectrogramImage;
+    int spectrogramWriteX = 0;
+    double spectrogramSampleRate = 0.0;
+    std::vector<int> spectrogramRowBinLo, spectrogramRowBinHi;   // FFT bins covered by each image row
+    juce::PixelARGB spectrogramPalette[256];
+    AudioPluginAudioProcessor::SpectrumFrame spectrumFrame;
+
+    // Newest contour frames, refreshed once per display frame while the overlay is on
+    bool showContour = false;
+    std::vector<AudioPluginAudioProcessor::ContourFrame> contourFrames;
+    int numContourFrames = 0;
+
+    // Most recent segmented notes, oldest overwritten first. offsetSample is -1 while sounding.
+    struct RollNote
+    {
+        int midiNote = -1;
+        int64_t onsetSample = 0;
+        int64_t offsetSample = 0;
+    };
+    static constexpr int ROLL_CAPACITY = 64;
+    bool showNoteRoll = false;
+    RollNote rollNotes[ROLL_CAPACITY];
+    int rollNext = 0;
+
+    // What the tuner and fretboard currently show. The needle eases towards the
+    // latest analysis result once per display frame instead of jumping per frame.
+    int shownNote = -1;
+    int shownString = -1;               // Identified from inharmonicity, -1 when unknown
+    int shownCalibrationString = -1;
+    ShowMe::Chord shownChord;           // Recognised chord and its pitch classes, while enabled
+    unsigned shownChordMask = 0;
+    float shownPitch = 0.0f;
+    float needleCents = 0.0f;
+    float paintedNeedleCents = 0.0f;
+    double lastVBlankMs = 0.0;
+
+    // Declared last so it stops before anything its callback touches is destroyed
+    juce::VBlankAttachment vblankAttachment;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessorEditor)
 };
@@ -4,15 +4,59 @@
 #include <chrono>
 #include <algorithm>
 
+namespace {
+    // Pitch contour range and hop
+    const float CONTOUR_MIN_HZ = 60.0f;
+    const float CONTOUR_MAX_HZ = 1500.0f;
+    const double CONTOUR_HOP_SECONDS = 0.003;
+
+    // Frames analysed per second, by the thread in realtime and on a fixed hop when rendering
+    const int ANALYSIS_RATE_HZ = 50;
+
+    // Note events go out on this channel with a velocity taken from the note's level
+    const int MIDI_OUT_CHANNEL = 1;
+    const float VELOCITY_FLOOR_DB = -60.0f;
+
+    // Highest fret a note is placed on when identifying its string
+    const int STRING_ID_MAX_FRET = 24;
+
+    // Single-slot write/read on an AbstractFifo-managed array; false when full/empty
+    template <typename T>
+    bool pushToFifo (juce::AbstractFifo& fifo, T* slots, const T& item)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+        if (size1 + size2 == 0)
+            return false;
+        slots[size1 > 0 ? start1 : start2] = item;
+        fifo.finishedWrite (1);
+        return true;
+    }
+
+    template <typename T>
+    bool popFromFifo (juce::AbstractFifo& fifo, const T* slots, T& item)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (1, start1, size1, start2, size2);
+        if (size1 + size2 == 0)
+            return false;
+        item = slots[size1 > 0 ? start1 : start2];
+        fifo.finishedRead (1);
+        return true;
+    }
+}
+
 AudioPluginAudioProcessor::AudioPluginAudioProcessor()
     : AudioProcessor (BusesProperties()
                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true))
 {
-    ringBuffer.resize (RING_BUFFER_SIZE, 0.0f);
-    analysisBuffer.resize (ANALYSIS_SIZE, 0.0f);
-    yinBuffer.resize (ANALYSIS_SIZE / 2, 0.0f);
+    // Contour updates read up to half the ring at once, so that much must stay contiguous
+    ringBuffer.allocate (RING_BUFFER_SIZE, RING_BUFFER_SIZE / 2);
+    yinBuffer.resize (BASS_ANALYSIS_SIZE / 2, 0.0f);
     pitchHistory.resize (PITCH_HISTORY_SIZE, 0.0f);
+    fftData.resize ((size_t) (2 << FFT_ORDER), 0.0f);
+    spectrumFrames.resize (SPECTRUM_FIFO_SIZE);
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
@@ -24,7 +68,7 @@ AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
 
 const juce::String AudioPluginAudioProcessor::getName() const { return JucePlugin_Name; }
 bool AudioPluginAudioProcessor::acceptsMidi() const { return false; }
-bool AudioPluginAudioProcessor::producesMidi() const { return false; }
+bool AudioPluginAudioProcessor::producesMidi() const { return true; }
 bool AudioPluginAudioProcessor::isMidiEffect() const { return false; }
 double AudioPluginAudioProcessor::getTailLengthSeconds() const { return 0.0; }
 int AudioPluginAudioProcessor::getNumPrograms() { return 1; }
@@ -35,12 +79,20 @@ void AudioPluginAudioProcessor::changeProgramName (int, const juce::String&) {}
 
 void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int)
 {
-    currentSampleRate = sampleRate;
-    writePos = 0;
-    smoothedPitch = 0.0f;
-    smoothedCents = 0.0f;
-    std::fill (ringBuffer.begin(), ringBuffer.end(), 0.0f);
-    std::fill (pitchHistory.begin(), pitchHistory.end(), 0.0f);
+    {
+        // The analysis thread may be mid-frame; everything it reads starts again from zero
+        const std::lock_guard<std::mutex> lock (analysisMutex);
+        currentSampleRate = sampleRate;
+        writePos = 0;
+        totalSamplesWritten = 0;
+        smoothedPitch = 0.0f;
+        smoothedCents = 0.0f;
+        midiSoundingNote = -1;
+        ringBuffer.clear();
+        std::fill (pitchHistory.begin(), pitchHistory.end(), 0.0f);
+        stringIdentifier.prepare (sampleRate);
+        resetAnalysisState();
+    }
 
     // Start background analysis thread
     if (!threadRunning)
@@ -69,8 +121,10 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     return true;
 }
 
-void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    midiMessages.clear();
+
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -91,17 +145,92 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     }
     signalLevel.store (std::sqrt (sumSquares / numSamples));
 
+    if (isNonRealtime())
+    {
+        processOffline (inputL, inputR, numSamples, midiMessages);
+        return;
+    }
+
+    writeNoteEventsToMidi (midiMessages, 0);
+    writeToRingBuffer (inputL, inputR, numSamples);
+
+    // Audio passes through unchanged
+}
+
+void AudioPluginAudioProcessor::writeToRingBuffer (const float* inputL, const float* inputR, int numSamples)
+{
     // Write to ring buffer (lock-free)
+    const int size = ringBuffer.getSize();
     int wp = writePos.load();
     for (int i = 0; i < numSamples; ++i)
     {
         float sample = (inputL[i] + inputR[i]) * 0.5f;
-        ringBuffer[wp] = sample;
-        wp = (wp + 1) % RING_BUFFER_SIZE;
+        ringBuffer.write (wp, sample);
+        if (++wp == size)
+            wp = 0;
     }
     writePos.store (wp);
+    totalSamplesWritten.store (totalSamplesWritten.load (std::memory_order_relaxed) + numSamples, std::memory_order_release);
+}
 
-    // Audio passes through unchanged
+void AudioPluginAudioProcessor::processOffline (const float* inputL, const float* inputR, int numSamples, juce::MidiBuffer& midi)
+{
+    // Rendering can run at any speed, so analyse here on a fixed sample hop instead of on the
+    // thread's clock. Frames land on the same sample positions whatever the block size, which
+    // makes bounces complete and repeatable. Blocking is fine off the realtime path.
+    const std::lock_guard<std::mutex> lock (analysisMutex);
+    const int hop = getOfflineHopSize();
+
+    int done = 0;
+    while (done < numSamples)
+    {
+        const int toBoundary = hop - (int) (totalSamplesWritten.load() % hop);
+        const int n = juce::jmin (toBoundary, numSamples - done);
+        writeToRingBuffer (inputL + done, inputR + done, n);
+        done += n;
+
+        if (n == toBoundary)
+        {
+            if (contourEnabled.load())
+                updateContour();
+
+            analyseFrame (getRecentRms (hop));
+            writeNoteEventsToMidi (midi, done - 1);
+        }
+    }
+}
+
+int AudioPluginAudioProcessor::getOfflineHopSize() const
+{
+    return juce::jmax (1, juce::roundToInt (currentSampleRate / ANALYSIS_RATE_HZ));
+}
+
+float AudioPluginAudioProcessor::getRecentRms (int numSamples) const
+{
+    numSamples = juce::jmin (numSamples, ringBuffer.getMaxWindow());
+    const float* window = ringBuffer.getWindow (totalSamplesWritten.load(), numSamples);
+    double sumSquares = 0.0;
+    for (int i = 0; i < numSamples; ++i)
+        sumSquares += window[i] * window[i];
+    return (float) std::sqrt (sumSquares / numSamples);
+}
+
+void AudioPluginAudioProcessor::resetAnalysisState()
+{
+    lastValidNote = -1;
+    lastValidPitch = 0.0f;
+    lastValidCents = 0.0f;
+    holdCounter = 0;
+    detectedPitch.store (0.0f);
+    detectedMidiNote.store (-1);
+    detectedCents.store (0.0f);
+    detectedString.store (-1);
+
+    segmenter.reset();
+    midiNoteFifo.reset();       // Only the audio thread reads it, and it is not running now
+    contourSampleRate = 0.0;    // Re-prepared, and restarted, on the next contour update
+    chromaSampleRate = 0.0;     // Likewise for the chord recogniser
+    publishChord ({}, 0);
 }
 
 void AudioPluginAudioProcessor::analyzerThread()
@@ -109,106 +238,163 @@ void AudioPluginAudioProcessor::analyzerThread()
     while (threadRunning)
     {
         // Run analysis ~50 times per second
-        std::this_thread::sleep_for (std::chrono::milliseconds (20));
+        std::this_thread::sleep_for (std::chrono::milliseconds (1000 / ANALYSIS_RATE_HZ));
 
         if (!threadRunning) break;
 
-        float rms = signalLevel.load();
-        debugRMS.store(rms);
+        // While the host renders offline, processBlock analyses on a fixed hop instead
+        if (isNonRealtime())
+            continue;
 
-        // Copy from ring buffer regardless of level
-        int wp = writePos.load();
-        for (int i = 0; i < ANALYSIS_SIZE; ++i)
-        {
-            int idx = (wp - ANALYSIS_SIZE + i + RING_BUFFER_SIZE) % RING_BUFFER_SIZE;
-            analysisBuffer[i] = ringBuffer[idx];
-        }
+        const std::lock_guard<std::mutex> lock (analysisMutex);
 
-        float confidence = 0.0f;
-        float pitch = detectPitchYIN (analysisBuffer.data(), ANALYSIS_SIZE, confidence);
+        if (contourEnabled.load())
+            updateContour();
+
+        analyseFrame (signalLevel.load());
+    }
+}
+
+void AudioPluginAudioProcessor::analyseFrame (float rms)
+{
+    debugRMS.store(rms);
 
-        // Store debug values
-        debugRawPitch.store(pitch);
-        debugConfidence.store(confidence);
+    // Analyse the newest samples in place, regardless of level. The writer is a quarter of a
+    // second of audio away from this window, far more than a frame takes.
+    const int64_t frameEnd = totalSamplesWritten.load (std::memory_order_acquire);
+    const int windowSize = bassMode.load() ? BASS_ANALYSIS_SIZE : ANALYSIS_SIZE;
+    const float* window = ringBuffer.getWindow (frameEnd, windowSize);
 
-        // Simple logic: if we have a valid pitch, show it
-        // Use user-adjustable threshold
-        float threshold = sensitivityThreshold.load();
+    float confidence = 0.0f;
+    float pitch = detectPitchYIN (window, windowSize, confidence);
 
-        // Calculate hold counter based on user setting (ms to frames at 50fps)
-        int holdFrames = (holdTimeMs.load() * 50) / 1000;
+    // Store debug values
+    debugRawPitch.store(pitch);
+    debugConfidence.store(confidence);
 
-        if (pitch > 20.0f && pitch < 5000.0f && confidence > threshold)
+    // Segment frames into note events
+    NoteSegmenter::Settings segmenterSettings;
+    segmenterSettings.confidenceThreshold = sensitivityThreshold.load();
+    segmenter.process ({ frameEnd, pitch, confidence, rms }, segmenterSettings,
+                       [this] (const NoteEvent& e) { publishNoteEvent (e); });
+
+    // One FFT feeds both the spectrogram and the chord recogniser
+    const bool wantSpectrum = spectrumEnabled.load();
+    const bool wantChords = chordsEnabled.load();
+    if (wantSpectrum || wantChords)
+        computeSpectrum (window + windowSize - (1 << FFT_ORDER));
+
+    if (wantSpectrum)
+        pushSpectrumFrame (confidence > sensitivityThreshold.load() ? pitch : 0.0f);
+
+    if (wantChords)
+        updateChords();
+    else if (detectedChordMask.load() != 0)
+        publishChord ({}, 0);
+
+    // Simple logic: if we have a valid pitch, show it
+    // Use user-adjustable threshold
+    float threshold = sensitivityThreshold.load();
+
+    // Calculate hold counter based on user setting (ms to analysis frames)
+    int holdFrames = (holdTimeMs.load() * ANALYSIS_RATE_HZ) / 1000;
+
+    auto decision = FlightRecorder::silent;
+
+    if (pitch > 20.0f && pitch < 5000.0f && confidence > threshold)
+    {
+        float midiNoteFloat = 69.0f + 12.0f * std::log2 (pitch / 440.0f);
+        int midiNote = (int) std::round (midiNoteFloat);
+        float cents = (midiNoteFloat - midiNote) * 100.0f;
+
+        // Octave jump protection: if we have a valid previous note,
+        // and the new note is exactly 12 semitones away (octave),
+        // require higher confidence to switch
+        bool acceptNote = true;
+        if (lastValidNote >= 0)
         {
-            float midiNoteFloat = 69.0f + 12.0f * std::log2 (pitch / 440.0f);
-            int midiNote = (int) std::round (midiNoteFloat);
-            float cents = (midiNoteFloat - midiNote) * 100.0f;
-
-            // Octave jump protection: if we have a valid previous note,
-            // and the new note is exactly 12 semitones away (octave),
-            // require higher confidence to switch
-            bool acceptNote = true;
-            if (lastValidNote >= 0)
+            int noteDiff = std::abs(midiNote - lastValidNote);
+            // If it's an octave jump (12 semitones) or close to it
+            if (noteDiff == 12 || noteDiff == 11 || noteDiff == 13)
             {
-                int noteDiff = std::abs(midiNote - lastValidNote);
-                // If it's an octave jump (12 semitones) or close to it
-                if (noteDiff == 12 || noteDiff == 11 || noteDiff == 13)
-                {
-                    // Require much higher confidence to accept octave jump
-                    if (confidence < 0.85f)
-                    {
-                        acceptNote = false;
-                    }
-                }
-                // For jumps of more than 7 semitones (a fifth), be more cautious
-                else if (noteDiff > 7 && confidence < 0.75f)
+                // Require much higher confidence to accept octave jump
+                if (confidence < 0.85f)
                 {
                     acceptNote = false;
                 }
             }
-
-            if (acceptNote)
+            // For jumps of more than 7 semitones (a fifth), be more cautious
+            else if (noteDiff > 7 && confidence < 0.75f)
             {
-                // Store as last valid
-                lastValidNote = midiNote;
-                lastValidPitch = pitch;
-                lastValidCents = cents;
-                holdCounter = holdFrames;
-
-                detectedPitch.store (pitch);
-                detectedMidiNote.store (midiNote);
-                detectedCents.store (cents);
-            }
-            else
-            {
-                // Rejected due to octave protection - keep showing last valid
-                if (holdCounter > 0)
-                {
-                    detectedPitch.store (lastValidPitch);
-                    detectedMidiNote.store (lastValidNote);
-                    detectedCents.store (lastValidCents);
-                }
+                acceptNote = false;
             }
         }
+
+        if (acceptNote)
+        {
+            // Store as last valid
+            lastValidNote = midiNote;
+            lastValidPitch = pitch;
+            lastValidCents = cents;
+            holdCounter = holdFrames;
+
+            detectedPitch.store (pitch);
+            detectedMidiNote.store (midiNote);
+            detectedCents.store (cents);
+            decision = FlightRecorder::accepted;
+        }
         else
         {
-            // No valid pitch - hold last note
+            decision = FlightRecorder::rejectedJump;
+
+            // Rejected due to octave protection - keep showing last valid
             if (holdCounter > 0)
             {
-                --holdCounter;
                 detectedPitch.store (lastValidPitch);
                 detectedMidiNote.store (lastValidNote);
                 detectedCents.store (lastValidCents);
             }
-            else
-            {
-                // Hold expired - show no signal
-                detectedPitch.store (0.0f);
-                detectedMidiNote.store (-1);
-                detectedCents.store (0.0f);
-            }
         }
     }
+    else
+    {
+        // No valid pitch - hold last note
+        if (holdCounter > 0)
+        {
+            decision = FlightRecorder::holding;
+            --holdCounter;
+            detectedPitch.store (lastValidPitch);
+            detectedMidiNote.store (lastValidNote);
+            detectedCents.store (lastValidCents);
+        }
+        else
+        {
+            // Hold expired - show no signal
+            detectedPitch.store (0.0f);
+            detectedMidiNote.store (-1);
+            detectedCents.store (0.0f);
+        }
+    }
+
+    // Which string, once calibrated: the partials are only measured on frames with a fresh pitch
+    if (stringIdentifier.isActive())
+    {
+        const float inharmonicity = decision == FlightRecorder::accepted
+                                        ? stringIdentifier.estimateInharmonicity (window, windowSize, pitch) : 0.0f;
+        detectedString.store (stringIdentifier.addFrame (detectedMidiNote.load(), inharmonicity, STRING_ID_MAX_FRET));
+        calibratingString.store (stringIdentifier.getCalibrationString());
+    }
+
+    FlightRecorder::Record record {};
+    record.samplePosition = frameEnd;
+    record.rms = rms;
+    record.rawPitch = pitch;
+    record.confidence = confidence;
+    record.shownPitch = detectedPitch.load();
+    record.shownNote = (int16_t) detectedMidiNote.load();
+    record.shownCents = detectedCents.load();
+    record.decision = decision;
+    flightRecorder.record (record);
 }
 
 float AudioPluginAudioProcessor::detectPitchYIN (const float* buffer, int numSamples, float& confidence)
@@ -223,16 +409,8 @@ float AudioPluginAudioProcessor::detectPitchYIN (const float* buffer, int numSam
     // yinBuffer[0] is always 1.0 by definition
     yinBuffer[0] = 1.0f;
 
-    // Compute difference function for all tau values
-    for (int tau = 1; tau < halfSize; ++tau)
-    {
-        yinBuffer[tau] = 0.0f;
-        for (int j = 0; j < halfSize; ++j)
-        {
-            float delta = buffer[j] - buffer[j + tau];
-            yinBuffer[tau] += delta * delta;
-        }
-    }
+    // Compute difference function for all tau values, split across cores for long windows
+    differenceKernel.compute (buffer, halfSize, yinBuffer.data());
 
     // Cumulative mean normalized difference function
     float runningSum = 0.0f;
@@ -329,6 +507,132 @@ float AudioPluginAudioProcessor::detectPitchYIN (const float* buffer, int numSam
     return (float) currentSampleRate / betterTau;
 }
 
+void AudioPluginAudioProcessor::computeSpectrum (const float* samples)
+{
+    const int fftSize = 1 << FFT_ORDER;
+    std::copy (samples, samples + fftSize, fftData.begin());
+    std::fill (fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+    fftWindow.multiplyWithWindowingTable (fftData.data(), (size_t) fftSize);
+    fft.performFrequencyOnlyForwardTransform (fftData.data(), true);
+}
+
+void AudioPluginAudioProcessor::updateChords()
+{
+    if (chromaSampleRate != currentSampleRate)
+    {
+        chromagram.prepare (currentSampleRate, 1 << FFT_ORDER, ANALYSIS_RATE_HZ);
+        chromaSampleRate = currentSampleRate;
+    }
+
+    chromagram.process (fftData.data());
+    publishChord (chromagram.getChord(), chromagram.getChordMask());
+}
+
+void AudioPluginAudioProcessor::publishChord (const ShowMe::Chord& chord, unsigned mask)
+{
+    detectedChordRoot.store (chord.root);
+    detectedChordType.store (chord.type);
+    detectedChordMask.store (mask);
+}
+
+void AudioPluginAudioProcessor::pushSpectrumFrame (float pitch)
+{
+    int start1, size1, start2, size2;
+    spectrumFifo.prepareToWrite (1, start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+        return;  // Editor is not keeping up - drop the frame rather than block
+
+    // Filled in place; a frame is too large to copy through pushToFifo.
+    // A full-scale sine reads 0 dB: N/2 for the transform, halved again by the Hann window's gain
+    auto& frame = spectrumFrames[(size_t) (size1 > 0 ? start1 : start2)];
+    const float scale = 4.0f / (float) (1 << FFT_ORDER);
+    for (int bin = 0; bin < SPECTRUM_BINS; ++bin)
+        frame.magnitudeDb[bin] = juce::Decibels::gainToDecibels (fftData[(size_t) bin] * scale, -120.0f);
+    frame.pitch = pitch;
+    spectrumFifo.finishedWrite (1);
+}
+
+bool AudioPluginAudioProcessor::popSpectrumFrame (SpectrumFrame& dest)
+{
+    return popFromFifo (spectrumFifo, spectrumFrames.data(), dest);
+}
+
+void AudioPluginAudioProcessor::updateContour()
+{
+    // Runs every sample written since the last pass through the tracker, hop by hop
+    const int64_t total = totalSamplesWritten.load (std::memory_order_acquire);
+
+    if (contourSampleRate != currentSampleRate)
+    {
+        contour.prepare (currentSampleRate, CONTOUR_MIN_HZ, CONTOUR_MAX_HZ, CONTOUR_HOP_SECONDS);
+        contourSampleRate = currentSampleRate;
+    }
+
+    const int maxCount = ringBuffer.getMaxWindow();
+    int64_t from = contourReadPosition;
+    if (total - from > maxCount || from > total)
+        from = total - maxCount;   // Fell behind or the stream restarted - skip ahead
+    from = std::max<int64_t> (0, from);
+
+    const int count = (int) (total - from);
+    contour.process (ringBuffer.getWindow (total, count), count, from, [this] (const ContourFrame& frame)
+    {
+        const int64_t n = contourFramesWritten.load (std::memory_order_relaxed);
+        contourRing[n % CONTOUR_RING_SIZE] = frame;
+        contourFramesWritten.store (n + 1, std::memory_order_release);
+    });
+
+    contourReadPosition = total;
+}
+
+int AudioPluginAudioProcessor::getRecentContour (ContourFrame* dest, int maxFrames) const
+{
+    const int64_t written = contourFramesWritten.load (std::memory_order_acquire);
+    const int count = (int) std::min<int64_t> ({ written, (int64_t) maxFrames, (int64_t) CONTOUR_RING_SIZE / 2 });
+
+    for (int i = 0; i < count; ++i)
+        dest[i] = contourRing[(written - count + i) % CONTOUR_RING_SIZE];
+    return count;
+}
+
+void AudioPluginAudioProcessor::publishNoteEvent (const NoteEvent& event)
+{
+    // A full queue drops the event: the editor may be closed, and MIDI out catches up on the next note
+    pushToFifo (editorNoteFifo, editorNoteEvents, event);
+    pushToFifo (midiNoteFifo, midiNoteEvents, event);
+}
+
+bool AudioPluginAudioProcessor::popNoteEvent (NoteEvent& dest)
+{
+    return popFromFifo (editorNoteFifo, editorNoteEvents, dest);
+}
+
+void AudioPluginAudioProcessor::writeNoteEventsToMidi (juce::MidiBuffer& midi, int sampleOffset)
+{
+    // Events describe the past, so they all go out at once: at the start of the block in
+    // realtime, at the analysis frame's sample when rendering offline
+    NoteEvent event;
+    while (popFromFifo (midiNoteFifo, midiNoteEvents, event))
+    {
+        if (event.type == NoteEvent::noteStarted)
+        {
+            if (midiSoundingNote >= 0)
+                midi.addEvent (juce::MidiMessage::noteOff (MIDI_OUT_CHANNEL, midiSoundingNote), sampleOffset);
+
+            const float db = juce::Decibels::gainToDecibels (event.level, VELOCITY_FLOOR_DB);
+            const int velocity = juce::jlimit (1, 127, (int) std::round (127.0f * (1.0f - db / VELOCITY_FLOOR_DB)));
+            midi.addEvent (juce::MidiMessage::noteOn (MIDI_OUT_CHANNEL, juce::jlimit (0, 127, event.midiNote), (juce::uint8) velocity), sampleOffset);
+            midiSoundingNote = juce::jlimit (0, 127, event.midiNote);
+        }
+        else if (event.midiNote == midiSoundingNote)
+        {
+            midi.addEvent (juce::MidiMessage::noteOff (MIDI_OUT_CHANNEL, midiSoundingNote), sampleOffset);
+            midiSoundingNote = -1;
+        }
+    }
+}
+
 bool AudioPluginAudioProcessor::hasEditor() const { return true; }
 
 juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor()
@@ -336,8 +640,44 @@ juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor()
     return new AudioPluginAudioProcessorEditor (*this);
 }
 
-void AudioPluginAudioProcessor::getStateInformation (juce::MemoryBlock&) {}
-void AudioPluginAudioProcessor::setStateInformation (const void*, int) {}
+void AudioPluginAudioProcessor::startStringCalibration (const int* openNotes, int numStrings)
+{
+    const std::lock_guard<std::mutex> lock (analysisMutex);
+    stringIdentifier.startCalibration (openNotes, numStrings);
+    calibratingString.store (stringIdentifier.getCalibrationString());
+    detectedString.store (-1);
+}
+
+void AudioPluginAudioProcessor::cancelStringCalibration()
+{
+    const std::lock_guard<std::mutex> lock (analysisMutex);
+    stringIdentifier.cancelCalibration();
+    calibratingString.store (-1);
+}
+
+void AudioPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    juce::ValueTree state ("ShowMeAudio");
+    {
+        const std::lock_guard<std::mutex> lock (analysisMutex);
+        state.setProperty ("stringProfiles", stringIdentifier.getProfiles(), nullptr);
+    }
+
+    if (auto xml = state.createXml())
+        copyXmlToBinary (*xml, destData);
+}
+
+void AudioPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    auto xml = getXmlFromBinary (data, sizeInBytes);
+    if (xml == nullptr)
+        return;
+
+    auto state = juce::ValueTree::fromXml (*xml);
+    const std::lock_guard<std::mutex> lock (analysisMutex);
+    stringIdentifier.setProfiles (state.getProperty ("stringProfiles").toString());
+    calibratingString.store (-1);
+}
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
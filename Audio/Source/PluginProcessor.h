@@ -1,6 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "PitchContour.h"
+#include "NoteSegmenter.h"
+#include "FlightRecorder.h"
+#include "MirroredRingBuffer.h"
+#include "DifferenceKernel.h"
+#include "StringIdentifier.h"
+#include "Chromagram.h"
 #include <vector>
 #include <atomic>
 #include <thread>
@@ -52,22 +59,126 @@ public:
     // User-adjustable hold time in milliseconds
     std::atomic<int> holdTimeMs { 400 };  // How long to hold note after signal drops
 
+    // Analyses twice as long a window: steadier on low strings, and reaches down to 30 Hz at
+    // high sample rates, at four times the cost per frame
+    std::atomic<bool> bassMode { false };
+
+    // Spectrogram feed - one magnitude frame per analysis pass, only computed while enabled
+    static constexpr int FFT_ORDER = 12;
+    static constexpr int SPECTRUM_BINS = (1 << FFT_ORDER) / 2;
+
+    struct SpectrumFrame
+    {
+        float magnitudeDb[SPECTRUM_BINS];
+        float pitch;        // Detected pitch for this frame, 0 if none
+    };
+
+    std::atomic<bool> spectrumEnabled { false };
+
+    // Message thread: takes the oldest queued frame, false when the queue is empty
+    bool popSpectrumFrame (SpectrumFrame& dest);
+
+    // Chord recognition from the same FFT, while enabled. Root and type index into
+    // ShowMe::CHORD_TYPES, -1 when no chord; the mask holds the chord's pitch classes, bit 0 = C.
+    std::atomic<bool> chordsEnabled { false };
+    std::atomic<int> detectedChordRoot { -1 };
+    std::atomic<int> detectedChordType { -1 };
+    std::atomic<unsigned> detectedChordMask { 0 };
+
+    // Pitch contour - a continuous pitch track at a ~3 ms hop for bends and vibrato, while enabled
+    using ContourFrame = PitchContour::Frame;
+    static constexpr int CONTOUR_RING_SIZE = 1024;
+
+    std::atomic<bool> contourEnabled { false };
+    std::atomic<int64_t> totalSamplesWritten { 0 };
+
+    // Copies the newest frames, oldest first, and returns how many were copied. Only the newest
+    // half of the ring is handed out, so the analysis thread cannot overwrite a frame mid-copy.
+    int getRecentContour (ContourFrame* dest, int maxFrames) const;
+
+    // Note events from the segmenter. The analysis thread publishes each event to two
+    // single-consumer queues: one drained by the editor, one by processBlock for MIDI out.
+    using NoteEvent = NoteSegmenter::NoteEvent;
+    bool popNoteEvent (NoteEvent& dest);
+
+    // String the shown note was played on, from its inharmonicity; -1 until the strings have
+    // been calibrated, or when the estimate is too close to call
+    std::atomic<int> detectedString { -1 };
+
+    // Message thread. Calibration asks for each open string in turn, highest string first;
+    // calibratingString is the one to pluck next, -1 when not calibrating.
+    void startStringCalibration (const int* openNotes, int numStrings);
+    void cancelStringCalibration();
+    std::atomic<int> calibratingString { -1 };
+
+    // Records every analysis frame to disk while started from the editor
+    FlightRecorder flightRecorder;
+
 private:
     // Background pitch detection
     void analyzerThread();
+    void analyseFrame (float rms);
+    void resetAnalysisState();
+    void writeToRingBuffer (const float* inputL, const float* inputR, int numSamples);
+    void processOffline (const float* inputL, const float* inputR, int numSamples, juce::MidiBuffer& midi);
+    int getOfflineHopSize() const;
+    float getRecentRms (int numSamples) const;
     float detectPitchYIN (const float* buffer, int numSamples, float& confidence);
+    void computeSpectrum (const float* samples);
+    void pushSpectrumFrame (float pitch);
+    void updateChords();
+    void publishChord (const ShowMe::Chord& chord, unsigned mask);
+    void updateContour();
+    void publishNoteEvent (const NoteEvent& event);
+    void writeNoteEventsToMidi (juce::MidiBuffer& midi, int sampleOffset);
 
     double currentSampleRate = 44100.0;
 
-    // Lock-free ring buffer for audio data
+    // Lock-free ring buffer for audio data; analysis windows are read from it in place
     static constexpr int RING_BUFFER_SIZE = 16384;
-    std::vector<float> ringBuffer;
+    MirroredRingBuffer ringBuffer;
     std::atomic<int> writePos { 0 };
 
-    // Analysis buffer (used by background thread)
+    // Analysis window (used by background thread)
     static constexpr int ANALYSIS_SIZE = 4096;
-    std::vector<float> analysisBuffer;
+    static constexpr int BASS_ANALYSIS_SIZE = 8192;
     std::vector<float> yinBuffer;
+    DifferenceKernel differenceKernel;
+    static_assert ((1 << FFT_ORDER) <= ANALYSIS_SIZE, "The spectrum is taken from the end of the analysis window");
+    static_assert (BASS_ANALYSIS_SIZE <= RING_BUFFER_SIZE / 2, "Windows must fit in the ring's contiguous span");
+
+    // Magnitude spectrum of the analysis window (analysis thread only)
+    juce::dsp::FFT fft { FFT_ORDER };
+    juce::dsp::WindowingFunction<float> fftWindow { (size_t) (1 << FFT_ORDER), juce::dsp::WindowingFunction<float>::hann, false };
+    std::vector<float> fftData;
+
+    // Chord recogniser state (analysis thread)
+    Chromagram chromagram;
+    double chromaSampleRate = 0.0;
+
+    // Single producer (analysis thread), single consumer (editor) frame queue
+    static constexpr int SPECTRUM_FIFO_SIZE = 32;
+    juce::AbstractFifo spectrumFifo { SPECTRUM_FIFO_SIZE };
+    std::vector<SpectrumFrame> spectrumFrames;
+
+    // Contour tracker state (analysis thread) and the published frame ring
+    PitchContour contour;
+    double contourSampleRate = 0.0;
+    int64_t contourReadPosition = 0;
+    ContourFrame contourRing[CONTOUR_RING_SIZE] {};
+    std::atomic<int64_t> contourFramesWritten { 0 };
+
+    // Inharmonicity-based string identification (analysis thread)
+    StringIdentifier stringIdentifier;
+
+    // Note segmentation (analysis thread) and its event queues
+    NoteSegmenter segmenter;
+    static constexpr int NOTE_FIFO_SIZE = 256;
+    juce::AbstractFifo editorNoteFifo { NOTE_FIFO_SIZE };
+    juce::AbstractFifo midiNoteFifo { NOTE_FIFO_SIZE };
+    NoteEvent editorNoteEvents[NOTE_FIFO_SIZE] {};
+    NoteEvent midiNoteEvents[NOTE_FIFO_SIZE] {};
+    int midiSoundingNote = -1;      // Audio thread only
 
     // Median filter for stability
     std::vector<float> pitchHistory;
@@ -77,6 +188,10 @@ private:
     std::thread pitchThread;
     std::atomic<bool> threadRunning { false };
 
+    // Held for each analysis frame, by the thread in realtime or by processBlock when rendering
+    // offline, so the two never analyse at once. Never taken on the realtime audio path.
+    std::mutex analysisMutex;
+
     // Smoothing and display stability
     float smoothedPitch = 0.0f;
     float smoothedCents = 0.0f;
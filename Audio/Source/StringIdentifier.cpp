@@ -0,0 +1,270 @@
+#include "StringIdentifier.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // 4096 newest samples, zero-padded four times: ~2.9 Hz bins at 48 kHz before interpolation
+    const int WINDOW_SIZE = 4096;
+    const int FFT_ORDER = 14;
+
+    const int MAX_PARTIALS = 24;
+    const int MIN_PARTIALS = 6;
+    const int MAX_MISSES = 3;               // Consecutive partials not found before giving up
+    const double MAX_PARTIAL_HZ = 6000.0;
+    const float PEAK_FLOOR = 1.0e-3f;       // -60 dB below the strongest partial
+    const double SEARCH_WIDTH = 0.2;        // Either side of the prediction, in multiples of f0
+
+    const float MIN_B = 1.0e-6f;
+    const float MAX_B = 1.0e-2f;
+
+    // A string must beat the runner-up by this much, in natural-log units of B, to be shown
+    const float MIN_MARGIN = 0.25f;
+    const float MAX_MISMATCH = 1.0f;
+
+    float median (float* values, int count)
+    {
+        std::nth_element (values, values + count / 2, values + count);
+        return values[count / 2];
+    }
+}
+
+StringIdentifier::StringIdentifier()
+    : fft (FFT_ORDER)
+{
+    window.resize ((size_t) WINDOW_SIZE);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), (size_t) WINDOW_SIZE,
+                                                              juce::dsp::WindowingFunction<float>::hann, false);
+    fftData.resize ((size_t) (2 << FFT_ORDER), 0.0f);
+}
+
+void StringIdentifier::prepare (double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    trackedNote = -1;
+    numEstimates = 0;
+}
+
+float StringIdentifier::estimateInharmonicity (const float* samples, int numSamples, float pitch)
+{
+    const int n = juce::jmin (numSamples, WINDOW_SIZE);
+    const float* newest = samples + numSamples - n;
+    for (int i = 0; i < n; ++i)
+        fftData[(size_t) i] = newest[i] * window[(size_t) i];
+    std::fill (fftData.begin() + n, fftData.end(), 0.0f);
+
+    fft.performFrequencyOnlyForwardTransform (fftData.data(), true);
+
+    const int fftSize = 1 << FFT_ORDER;
+    return estimateFromSpectrum (fftData.data(), fftSize / 2, sampleRate / fftSize, pitch);
+}
+
+float StringIdentifier::estimateFromSpectrum (const float* magnitudes, int numBins, double binHz, float pitch)
+{
+    if (pitch <= 0.0f || binHz <= 0.0)
+        return 0.0f;
+
+    // Peak bin in [lo, hi], refined by a parabola through the log magnitudes; 0 if none
+    auto findPeak = [&] (double centreHz, double halfWidthHz, float& magnitude)
+    {
+        const int lo = juce::jmax (1, (int) std::floor ((centreHz - halfWidthHz) / binHz));
+        const int hi = juce::jmin (numBins - 2, (int) std::ceil ((centreHz + halfWidthHz) / binHz));
+        if (hi - lo < 2)
+            return 0.0;
+
+        int best = lo;
+        for (int b = lo + 1; b <= hi; ++b)
+            if (magnitudes[b] > magnitudes[best])
+                best = b;
+
+        // The largest value at the edge of the range is a slope, not a peak
+        if (best == lo || best == hi)
+            return 0.0;
+
+        const double a = std::log (magnitudes[best - 1] + 1.0e-12);
+        const double b = std::log (magnitudes[best] + 1.0e-12);
+        const double c = std::log (magnitudes[best + 1] + 1.0e-12);
+        const double denom = a - 2.0 * b + c;
+        const double offset = denom < 0.0 ? 0.5 * (a - c) / denom : 0.0;
+
+        magnitude = magnitudes[best];
+        return (best + juce::jlimit (-0.5, 0.5, offset)) * binHz;
+    };
+
+    // Weighted least squares of (f_k / k)^2 = f0^2 + f0^2 B k^2 over the partials found so far
+    double sw = 0.0, sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    int count = 0;
+    double fittedF0 = pitch, fittedB = 0.0;
+
+    auto refit = [&]
+    {
+        const double det = sw * sxx - sx * sx;
+        if (count < 3 || det <= 0.0)
+            return;
+
+        const double slope = (sw * sxy - sx * sy) / det;
+        const double intercept = (sy - slope * sx) / sw;
+        if (intercept <= 0.0)
+            return;
+
+        fittedF0 = std::sqrt (intercept);
+        fittedB = juce::jmax (0.0, slope / intercept);
+    };
+
+    float strongest = 0.0f;
+    const double topHz = juce::jmin (MAX_PARTIAL_HZ, binHz * numBins * 0.9);
+    int misses = 0;
+
+    for (int k = 1; k <= MAX_PARTIALS && misses < MAX_MISSES; ++k)
+    {
+        const double predicted = k * fittedF0 * std::sqrt (1.0 + fittedB * k * k);
+        if (predicted > topHz)
+            break;
+
+        float magnitude = 0.0f;
+        const double hz = findPeak (predicted, SEARCH_WIDTH * fittedF0, magnitude);
+        if (hz <= 0.0 || magnitude < strongest * PEAK_FLOOR)
+        {
+            ++misses;
+            continue;
+        }
+
+        misses = 0;
+        strongest = juce::jmax (strongest, magnitude);
+
+        // Low partials carry the larger relative error, so lean on the higher ones
+        const double x = (double) k * k;
+        const double y = (hz / k) * (hz / k);
+        const double w = (double) k;
+        sw += w; sx += w * x; sy += w * y; sxx += w * x * x; sxy += w * x * y;
+        ++count;
+        refit();
+    }
+
+    if (count < MIN_PARTIALS)
+        return 0.0f;
+
+    return juce::jlimit (MIN_B, MAX_B, (float) fittedB);
+}
+
+void StringIdentifier::startCalibration (const int* openNotes, int strings)
+{
+    numStrings = juce::jlimit (0, MAX_STRINGS, strings);
+    std::copy (openNotes, openNotes + numStrings, tuning);
+    std::fill (openStringB, openStringB + MAX_STRINGS, 0.0f);
+
+    trackedNote = -1;
+    numEstimates = 0;
+    calibrationString = numStrings > 0 ? 0 : -1;
+}
+
+void StringIdentifier::addEstimate (float inharmonicity)
+{
+    estimates[numEstimates % CALIBRATION_FRAMES] = inharmonicity;
+    ++numEstimates;
+}
+
+float StringIdentifier::getMedianEstimate() const
+{
+    float sorted[CALIBRATION_FRAMES];
+    const int count = juce::jmin (numEstimates, CALIBRATION_FRAMES);
+    std::copy (estimates, estimates + count, sorted);
+    return median (sorted, count);
+}
+
+int StringIdentifier::addFrame (int midiNote, float inharmonicity, int maxFret)
+{
+    if (midiNote != trackedNote)
+    {
+        trackedNote = midiNote;
+        numEstimates = 0;
+    }
+
+    if (midiNote < 0)
+        return -1;
+
+    if (calibrationString >= 0)
+    {
+        // Only the open string being asked for counts
+        if (midiNote != tuning[calibrationString] || inharmonicity <= 0.0f)
+            return -1;
+
+        addEstimate (inharmonicity);
+        if (numEstimates >= CALIBRATION_FRAMES)
+        {
+            openStringB[calibrationString] = getMedianEstimate();
+            numEstimates = 0;
+            trackedNote = -1;
+            if (++calibrationString >= numStrings)
+                calibrationString = -1;
+        }
+        return -1;
+    }
+
+    // Frames without an estimate, such as held ones, keep the answer the note already has
+    if (inharmonicity > 0.0f)
+        addEstimate (inharmonicity);
+
+    return numEstimates > 0 ? identify (midiNote, getMedianEstimate(), maxFret) : -1;
+}
+
+int StringIdentifier::identify (int midiNote, float inharmonicity, int maxFret) const
+{
+    int best = -1;
+    float bestError = 1.0e9f, secondError = 1.0e9f;
+
+    for (int s = 0; s < numStrings; ++s)
+    {
+        const int fret = midiNote - tuning[s];
+        if (fret < 0 || fret > maxFret || openStringB[s] <= 0.0f)
+            continue;
+
+        // Stopping the string shortens it, and B grows with the inverse square of the length
+        const float expected = openStringB[s] * std::exp2 ((float) fret / 6.0f);
+        const float error = std::abs (std::log (inharmonicity / expected));
+
+        if (error < bestError)
+        {
+            secondError = bestError;
+            bestError = error;
+            best = s;
+        }
+        else if (error < secondError)
+        {
+            secondError = error;
+        }
+    }
+
+    if (bestError > MAX_MISMATCH || secondError - bestError < MIN_MARGIN)
+        return -1;
+    return best;
+}
+
+bool StringIdentifier::isCalibrated() const
+{
+    return calibrationString < 0 && numStrings > 0
+            && std::all_of (openStringB, openStringB + numStrings, [] (float b) { return b > 0.0f; });
+}
+
+juce::String StringIdentifier::getProfiles() const
+{
+    juce::StringArray parts;
+    for (int s = 0; s < numStrings; ++s)
+        parts.add (juce::String (tuning[s]) + ":" + juce::String (openStringB[s], 8));
+    return parts.joinIntoString (" ");
+}
+
+void StringIdentifier::setProfiles (const juce::String& profiles)
+{
+    numStrings = 0;
+    calibrationString = -1;
+
+    for (const auto& part : juce::StringArray::fromTokens (profiles, " ", {}))
+    {
+        if (numStrings == MAX_STRINGS || ! part.containsChar (':'))
+            break;
+
+        tuning[numStrings] = part.upToFirstOccurrenceOf (":", false, false).getIntValue();
+        openStringB[numStrings] = part.fromFirstOccurrenceOf (":", false, false).getFloatValue();
+        ++numStrings;
+    }
+}
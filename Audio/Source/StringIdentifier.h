@@ -0,0 +1,67 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+// Works out which string a note was played on from its inharmonicity. A stiff string's
+// partials run sharp, f_k = k * f0 * sqrt (1 + B k^2), and B depends on the string's gauge and
+// core as well as its speaking length: fretting up f frets scales it by about 2^(f/6). The same
+// pitch therefore has a different B on each string that can play it.
+//
+// Partials are tracked on a zero-padded FFT with parabolic peak interpolation, and B comes from
+// a least-squares fit. Open-string B values are learned in a calibration pass, one string at a
+// time. Until the strings are calibrated, identify() returns -1.
+class StringIdentifier
+{
+public:
+    static constexpr int MAX_STRINGS = 8;
+    static constexpr int CALIBRATION_FRAMES = 20;   // Estimates taken per open string
+
+    StringIdentifier();
+
+    void prepare (double sampleRate);
+
+    // Estimates B from the newest samples of a window, given the detected pitch. Returns 0 when
+    // too few partials stand out to fit.
+    float estimateInharmonicity (const float* samples, int numSamples, float pitch);
+
+    // Fits B to the partials of f0 in a magnitude spectrum; binHz is the spacing of the bins
+    static float estimateFromSpectrum (const float* magnitudes, int numBins, double binHz, float pitch);
+
+    // Tuning is given as open-string MIDI notes, highest string first
+    void startCalibration (const int* openNotes, int numStrings);
+    void cancelCalibration()                    { calibrationString = -1; }
+    int getCalibrationString() const            { return calibrationString; }
+
+    // Called every frame with the shown note (-1 when none) and its estimate (0 when none).
+    // Feeds the calibration while it runs; otherwise returns the string the note is on, from
+    // the median of its estimates so far, or -1 when unknown or too close to call.
+    int addFrame (int midiNote, float inharmonicity, int maxFret);
+
+    bool isCalibrated() const;
+    bool isActive() const                       { return calibrationString >= 0 || isCalibrated(); }
+
+    // Open-string B per string, 0 for strings not calibrated; saved with the plugin state
+    juce::String getProfiles() const;
+    void setProfiles (const juce::String& profiles);
+
+private:
+    int identify (int midiNote, float inharmonicity, int maxFret) const;
+    void addEstimate (float inharmonicity);
+    float getMedianEstimate() const;
+
+    double sampleRate = 44100.0;
+    juce::dsp::FFT fft;
+    std::vector<float> window;
+    std::vector<float> fftData;
+
+    int tuning[MAX_STRINGS] {};
+    int numStrings = 0;
+    float openStringB[MAX_STRINGS] {};
+
+    // Estimates for the note being played, or the open string being calibrated
+    int trackedNote = -1;
+    float estimates[CALIBRATION_FRAMES] {};
+    int numEstimates = 0;
+    int calibrationString = -1;
+};
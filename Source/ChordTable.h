@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Scales.h"
+#include <cstdint>
+#include <cstdio>
+
+// Chord naming from a 12-bit pitch-class mask (bit 0 = C).
+// Both lookup tables are built at compile time, so naming a chord at runtime
+// is two array reads and never a search over chord shapes.
+namespace ShowMe
+{
+    struct ChordType
+    {
+        const char* suffix;
+        unsigned intervals;     // 12-bit mask relative to the root, bit 0 = root
+    };
+
+    constexpr unsigned intervalMask (int a, int b, int c = -1, int d = -1, int e = -1, int f = -1)
+    {
+        unsigned m = (1u << a) | (1u << b);
+        if (c >= 0) m |= 1u << c;
+        if (d >= 0) m |= 1u << d;
+        if (e >= 0) m |= 1u << e;
+        if (f >= 0) m |= 1u << f;
+        return m;
+    }
+
+    // Earlier entries win when one set of notes fits several shapes
+    constexpr ChordType CHORD_TYPES[] = {
+        { "",      intervalMask (0, 4, 7) },
+        { "m",     intervalMask (0, 3, 7) },
+        { "7",     intervalMask (0, 4, 7, 10) },
+        { "maj7",  intervalMask (0, 4, 7, 11) },
+        { "m7",    intervalMask (0, 3, 7, 10) },
+        { "dim",   intervalMask (0, 3, 6) },
+        { "aug",   intervalMask (0, 4, 8) },
+        { "sus4",  intervalMask (0, 5, 7) },
+        { "sus2",  intervalMask (0, 2, 7) },
+        { "5",     intervalMask (0, 7) },
+        { "6",     intervalMask (0, 4, 7, 9) },
+        { "m6",    intervalMask (0, 3, 7, 9) },
+        { "dim7",  intervalMask (0, 3, 6, 9) },
+        { "m7b5",  intervalMask (0, 3, 6, 10) },
+        { "mMaj7", intervalMask (0, 3, 7, 11) },
+        { "7sus4", intervalMask (0, 5, 7, 10) },
+        { "add9",  intervalMask (0, 2, 4, 7) },
+        { "madd9", intervalMask (0, 2, 3, 7) },
+        { "9",     intervalMask (0, 2, 4, 7, 10) },
+        { "maj9",  intervalMask (0, 2, 4, 7, 11) },
+        { "m9",    intervalMask (0, 2, 3, 7, 10) },
+        { "6/9",   intervalMask (0, 2, 4, 7, 9) },
+        { "7b9",   intervalMask (0, 1, 4, 7, 10) },
+        { "7#9",   intervalMask (0, 3, 4, 7, 10) },
+        { "11",    intervalMask (0, 2, 4, 5, 7, 10) },
+        { "m11",   intervalMask (0, 2, 3, 5, 7, 10) },
+        { "13",    intervalMask (0, 2, 4, 7, 9, 10) },
+        { "maj13", intervalMask (0, 2, 4, 7, 9, 11) },
+        // Guitar voicings that drop the fifth
+        { "7",     intervalMask (0, 4, 10) },
+        { "maj7",  intervalMask (0, 4, 11) },
+        { "m7",    intervalMask (0, 3, 10) },
+        { "9",     intervalMask (0, 2, 4, 10) },
+        { "7#9",   intervalMask (0, 3, 4, 10) },
+    };
+    constexpr int NUM_CHORD_TYPES = (int) (sizeof (CHORD_TYPES) / sizeof (CHORD_TYPES[0]));
+    constexpr uint8_t NO_CHORD = 0xff;
+
+    struct ChordEntry
+    {
+        uint8_t root = NO_CHORD;
+        uint8_t type = NO_CHORD;
+    };
+
+    struct ChordTables
+    {
+        ChordEntry byMask[4096] {};      // absolute pitch classes -> root and type
+        uint8_t byIntervals[4096] {};    // pitch classes relative to a given root -> type
+    };
+
+    constexpr ChordTables buildChordTables()
+    {
+        ChordTables t {};
+        for (int m = 0; m < 4096; ++m)
+            t.byIntervals[m] = NO_CHORD;
+
+        for (int type = 0; type < NUM_CHORD_TYPES; ++type)
+        {
+            const unsigned intervals = CHORD_TYPES[type].intervals;
+            if (t.byIntervals[intervals] == NO_CHORD)
+                t.byIntervals[intervals] = (uint8_t) type;
+
+            for (int root = 0; root < 12; ++root)
+            {
+                auto& e = t.byMask[rotateMask (intervals, root)];
+                if (e.type == NO_CHORD)
+                    e = { (uint8_t) root, (uint8_t) type };
+            }
+        }
+        return t;
+    }
+
+    constexpr ChordTables CHORD_TABLES = buildChordTables();
+
+    struct Chord
+    {
+        int root = -1;
+        int type = -1;
+        int bass = -1;
+
+        bool isValid() const                    { return root >= 0; }
+        bool operator== (const Chord& o) const  { return root == o.root && type == o.type && bass == o.bass; }
+        bool operator!= (const Chord& o) const  { return ! operator== (o); }
+    };
+
+    // Names the chord for a set of pitch classes. When the lowest note gives a root-position
+    // reading that is used, otherwise the table's reading is shown over the bass, e.g. C/E.
+    inline Chord recogniseChord (unsigned pitchClassMask, int bassPitchClass)
+    {
+        pitchClassMask &= 0xfffu;
+        if (bassPitchClass >= 0)
+        {
+            const uint8_t type = CHORD_TABLES.byIntervals[rotateMask (pitchClassMask, -bassPitchClass)];
+            if (type != NO_CHORD)
+                return { bassPitchClass, type, bassPitchClass };
+        }
+
+        const auto& e = CHORD_TABLES.byMask[pitchClassMask];
+        if (e.type == NO_CHORD)
+            return {};
+        return { e.root, e.type, bassPitchClass >= 0 ? bassPitchClass : e.root };
+    }
+
+    // Writes e.g. "Am7/E" into out without allocating
+    inline void formatChord (const Chord& chord, char* out, int outSize)
+    {
+        if (! chord.isValid())
+        {
+            std::snprintf (out, (size_t) outSize, "-");
+            return;
+        }
+
+        if (chord.bass >= 0 && chord.bass != chord.root)
+            std::snprintf (out, (size_t) outSize, "%s%s/%s", NOTE_NAMES[chord.root],
+                           CHORD_TYPES[chord.type].suffix, NOTE_NAMES[chord.bass]);
+        else
+            std::snprintf (out, (size_t) outSize, "%s%s", NOTE_NAMES[chord.root], CHORD_TYPES[chord.type].suffix);
+    }
+}
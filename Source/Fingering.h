@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdlib>
+
+// Fingering logic shared by the Show Me MIDI editor and the offline tools.
+// Kept free of JUCE and of heap allocation so it can also run on the audio thread.
+namespace ShowMe
+{
+    constexpr int MAX_STRINGS = 8;
+
+    // Standard tuning, high E first, extended down to 8 strings
+    constexpr int GUITAR_TUNING[MAX_STRINGS] = { 64, 59, 55, 50, 45, 40, 35, 30 };  // E4, B3, G3, D3, A2, E2, B1, F#1
+
+    struct NotePosition
+    {
+        int stringIndex;
+        int fret;
+        int midiNote;
+    };
+
+    class Fingering
+    {
+    public:
+        // Finds the string/fret for midiNote closest to the current hand position,
+        // preferring frets inside the position zone. Strings flagged in usedStrings
+        // (bit per string) are only chosen when nothing else can play the note.
+        NotePosition findOptimalPosition (int midiNote, int preferredPosition, int fingerRange,
+                                          int numStrings, int totalFrets, unsigned usedStrings = 0) const
+        {
+            if (numStrings > MAX_STRINGS) numStrings = MAX_STRINGS;
+
+            NotePosition best { -1, -1, midiNote };
+            int bestTier = 4;
+            int bestD = 0;
+
+            for (int s = 0; s < numStrings; ++s)
+            {
+                int f = midiNote - GUITAR_TUNING[s];
+                if (f < 0 || f > totalFrets)
+                    continue;
+
+                int d = std::abs (s - currentString) + std::abs (f - currentFret);
+                bool inZone = (f >= preferredPosition && f <= preferredPosition + fingerRange - 1);
+                bool free = (usedStrings & (1u << s)) == 0;
+
+                // Lower tier wins: free in zone, free, used in zone, used
+                int tier = (free ? 0 : 2) + (inZone ? 0 : 1);
+                if (tier < bestTier || (tier == bestTier && d < bestD))
+                {
+                    bestTier = tier;
+                    bestD = d;
+                    best = { s, f, midiNote };
+                }
+            }
+
+            return best;
+        }
+
+        // Moves the hand to a chosen position so the next note is picked relative to it
+        void moveTo (const NotePosition& pos)
+        {
+            if (pos.stringIndex < 0) return;
+            currentString = pos.stringIndex;
+            currentFret = pos.fret;
+        }
+
+        void reset()
+        {
+            currentString = 2;
+            currentFret = 5;
+        }
+
+        int currentString = 2;
+        int currentFret = 5;
+    };
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "Scales.h"
+#include <cmath>
+
+// Guesses key and scale from played notes.
+// Keeps a decaying pitch-class histogram and scores it against every key x scale mask.
+// Allocation free and bounded (12 x NUM_SCALES masks, 12 bins each), so it runs on the audio thread.
+class KeyDetector
+{
+public:
+    struct Match
+    {
+        int key = -1;
+        int scale = -1;
+        float score = 0.0f;
+    };
+
+    KeyDetector()
+    {
+        for (int k = 0; k < 12; ++k)
+            for (int sc = 0; sc < ShowMe::NUM_SCALES; ++sc)
+                masks[k][sc] = ShowMe::rotateMask (ShowMe::scaleMask (sc), k);
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& h : histogram) h = 0.0f;
+        pendingSeconds = 0.0;
+        current = {};
+        challenger = {};
+        challengerCount = 0;
+    }
+
+    // Time passing without notes; decay is applied lazily on the next note
+    void advance (double seconds)               { pendingSeconds += seconds; }
+
+    void addNote (int midiNote, int velocity)
+    {
+        if (pendingSeconds > 0.0)
+        {
+            const float decay = (float) std::exp (-pendingSeconds / DECAY_SECONDS);
+            for (auto& h : histogram) h *= decay;
+            pendingSeconds = 0.0;
+        }
+
+        histogram[midiNote % 12] += 0.5f + (float) velocity / 254.0f;
+    }
+
+    // Re-scores all key/scale pairs and returns the stable choice.
+    // A different best fit must win by HYSTERESIS_MARGIN several updates in a row before it replaces the current one.
+    Match update()
+    {
+        float total = 0.0f;
+        for (auto h : histogram) total += h;
+        if (total < MIN_EVIDENCE)
+            return current;
+
+        Match best = findBestMatch (total);
+
+        if (current.key < 0)
+        {
+            current = best;
+            return current;
+        }
+
+        if (best.key == current.key && best.scale == current.scale)
+        {
+            current.score = best.score;
+            challengerCount = 0;
+            return current;
+        }
+
+        const float currentScore = scoreMask (masks[current.key][current.scale], current.key, total);
+        current.score = currentScore;
+
+        if (best.score > currentScore + HYSTERESIS_MARGIN)
+        {
+            if (best.key == challenger.key && best.scale == challenger.scale)
+                ++challengerCount;
+            else
+                challengerCount = 1;
+
+            challenger = best;
+            if (challengerCount >= HYSTERESIS_UPDATES)
+            {
+                current = best;
+                challengerCount = 0;
+            }
+        }
+        else
+        {
+            challengerCount = 0;
+        }
+
+        return current;
+    }
+
+    Match getCurrent() const                    { return current; }
+
+private:
+    // Fraction of the played weight that is in the scale, minus a small cost per scale note so
+    // the chromatic scale does not win everything, plus a bonus for a strongly played root
+    float scoreMask (unsigned mask, int key, float total) const
+    {
+        float inScale = 0.0f;
+        int size = 0;
+        for (int pc = 0; pc < 12; ++pc)
+        {
+            if (mask & (1u << pc))
+            {
+                inScale += histogram[pc];
+                ++size;
+            }
+        }
+
+        return inScale / total - SIZE_PENALTY * (float) size / 12.0f + ROOT_BONUS * histogram[key] / total;
+    }
+
+    Match findBestMatch (float total) const
+    {
+        Match best;
+        best.score = -1.0e9f;
+
+        // Scale order breaks ties, so Major/Minor win over their modes
+        for (int sc = 0; sc < ShowMe::NUM_SCALES; ++sc)
+        {
+            for (int k = 0; k < 12; ++k)
+            {
+                float score = scoreMask (masks[k][sc], k, total);
+                if (score > best.score)
+                    best = { k, sc, score };
+            }
+        }
+
+        return best;
+    }
+
+    static constexpr double DECAY_SECONDS = 20.0;
+    static constexpr float MIN_EVIDENCE = 6.0f;
+    static constexpr float SIZE_PENALTY = 0.25f;
+    static constexpr float ROOT_BONUS = 0.2f;
+    static constexpr float HYSTERESIS_MARGIN = 0.03f;
+    static constexpr int HYSTERESIS_UPDATES = 3;
+
+    unsigned masks[12][ShowMe::NUM_SCALES];
+    float histogram[12];
+    double pendingSeconds = 0.0;
+
+    Match current;
+    Match challenger;
+    int challengerCount = 0;
+};
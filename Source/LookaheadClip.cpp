@@ -0,0 +1,72 @@
+#include "LookaheadClip.h"
+
+namespace {
+    const int DRUM_CHANNEL = 10;
+}
+
+juce::String LookaheadClip::loadFromFile (const juce::File& file)
+{
+    juce::FileInputStream stream (file);
+    if (! stream.openedOk())
+        return "Cannot open " + file.getFileName();
+
+    juce::MidiFile midi;
+    if (! midi.readFrom (stream))
+        return file.getFileName() + " is not a valid MIDI file";
+
+    const int ticksPerQuarter = midi.getTimeFormat();
+    if (ticksPerQuarter <= 0)
+        return "SMPTE-timed MIDI files are not supported";
+
+    std::vector<Note> loaded;
+    double length = 0.0;
+
+    for (int t = 0; t < midi.getNumTracks(); ++t)
+    {
+        juce::MidiMessageSequence track (*midi.getTrack (t));
+        track.updateMatchedPairs();
+
+        for (int i = 0; i < track.getNumEvents(); ++i)
+        {
+            const auto& msg = track.getEventPointer (i)->message;
+            if (! msg.isNoteOn() || msg.getChannel() == DRUM_CHANNEL)
+                continue;
+
+            double start = msg.getTimeStamp() / ticksPerQuarter;
+            double end = track.getTimeOfMatchingKeyUp (i) / ticksPerQuarter;
+            if (end <= start)
+                end = start + 0.25;
+
+            loaded.push_back ({ start, end, msg.getNoteNumber() });
+            length = juce::jmax (length, end);
+        }
+    }
+
+    std::sort (loaded.begin(), loaded.end(), [] (const Note& a, const Note& b)
+    {
+        if (a.startBeat != b.startBeat) return a.startBeat < b.startBeat;
+        return a.midiNote < b.midiNote;
+    });
+
+    notes = std::move (loaded);
+    startBeats.resize (notes.size());
+    maxDuration = 0.0;
+    for (size_t i = 0; i < notes.size(); ++i)
+    {
+        startBeats[i] = notes[i].startBeat;
+        maxDuration = juce::jmax (maxDuration, notes[i].endBeat - notes[i].startBeat);
+    }
+
+    lengthInBeats = length;
+    sourceFile = file;
+    return {};
+}
+
+void LookaheadClip::clear()
+{
+    notes.clear();
+    startBeats.clear();
+    maxDuration = 0.0;
+    lengthInBeats = 0.0;
+    sourceFile = juce::File();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include <algorithm>
+
+// A MIDI clip indexed by time in quarter notes, used to show upcoming notes ahead of the playhead.
+// Notes live in one flat array sorted by start beat with the start beats mirrored in a
+// separate array, so a range query is a binary search plus a short linear scan.
+// Loading allocates and must happen off the audio thread; queries never allocate.
+class LookaheadClip
+{
+public:
+    struct Note
+    {
+        double startBeat;
+        double endBeat;
+        int midiNote;
+    };
+
+    // Replaces the clip with the notes of a .mid file. Returns an error message, or empty on success.
+    juce::String loadFromFile (const juce::File& file);
+    void clear();
+
+    bool isEmpty() const                        { return notes.empty(); }
+    int getNumNotes() const                     { return (int) notes.size(); }
+    double getLengthInBeats() const             { return lengthInBeats; }
+    const juce::File& getFile() const           { return sourceFile; }
+
+    // Calls fn (const Note&) for every note that starts in [fromBeat, toBeat), in start order
+    template <typename Fn>
+    void forEachNoteStartingIn (double fromBeat, double toBeat, Fn&& fn) const
+    {
+        auto first = std::lower_bound (startBeats.begin(), startBeats.end(), fromBeat);
+        for (auto i = (size_t) (first - startBeats.begin()); i < notes.size() && startBeats[i] < toBeat; ++i)
+            fn (notes[i]);
+    }
+
+    // Calls fn (const Note&) for every note sounding at any point in [fromBeat, toBeat).
+    // Notes can start at most maxDuration before fromBeat, which bounds the scan.
+    template <typename Fn>
+    void forEachNoteOverlapping (double fromBeat, double toBeat, Fn&& fn) const
+    {
+        auto first = std::lower_bound (startBeats.begin(), startBeats.end(), fromBeat - maxDuration);
+        for (auto i = (size_t) (first - startBeats.begin()); i < notes.size() && startBeats[i] < toBeat; ++i)
+            if (notes[i].endBeat > fromBeat)
+                fn (notes[i]);
+    }
+
+private:
+    std::vector<Note> notes;
+    std::vector<double> startBeats;
+    double maxDuration = 0.0;
+    double lengthInBeats = 0.0;
+    juce::File sourceFile;
+};
@@ -0,0 +1,75 @@
+#include "NoteLabelAtlas.h"
+#include "Scales.h"
+
+bool NoteLabelAtlas::Params::operator== (const Params& o) const
+{
+    if (cellWidth != o.cellWidth || cellHeight != o.cellHeight || fontHeight != o.fontHeight
+     || cornerSize != o.cornerSize || glowMargin != o.glowMargin || glowCornerSize != o.glowCornerSize
+     || pixelScale != o.pixelScale)
+        return false;
+
+    for (int i = 0; i < numStates; ++i)
+        if (styles[i].background != o.styles[i].background || styles[i].text != o.styles[i].text)
+            return false;
+
+    return true;
+}
+
+bool NoteLabelAtlas::prepare (const Params& newParams)
+{
+    if (atlas.isValid() && newParams == params)
+        return false;
+
+    params = newParams;
+
+    const float scale = params.pixelScale;
+    const int tileW = juce::jmax (1, (int) std::ceil ((params.cellWidth + params.glowMargin * 2.0f) * scale));
+    const int tileH = juce::jmax (1, (int) std::ceil ((params.cellHeight + params.glowMargin * 2.0f) * scale));
+
+    atlas = juce::Image (juce::Image::ARGB, tileW * 12, tileH * numStates, true);
+    juce::Graphics g (atlas);
+    const juce::Font font (params.fontHeight);
+
+    for (int state = 0; state < numStates; ++state)
+    {
+        const auto& style = params.styles[state];
+
+        for (int pc = 0; pc < 12; ++pc)
+        {
+            juce::Graphics::ScopedSaveState save (g);
+            g.setOrigin (pc * tileW, state * tileH);
+            g.reduceClipRegion (0, 0, tileW, tileH);
+            g.addTransform (juce::AffineTransform::scale (scale));
+
+            juce::Rectangle<float> cell (params.glowMargin, params.glowMargin, params.cellWidth, params.cellHeight);
+
+            if (state == active)
+            {
+                g.setColour (style.background.withAlpha (0.4f));
+                g.fillRoundedRectangle (cell.expanded (params.glowMargin), params.glowCornerSize);
+            }
+
+            g.setColour (style.background);
+            g.fillRoundedRectangle (cell, params.cornerSize);
+
+            g.setColour (style.text);
+            g.setFont (font);
+            g.drawText (ShowMe::NOTE_NAMES[pc], cell, juce::Justification::centred, false);
+
+            tiles[state][pc] = atlas.getClippedImage ({ pc * tileW, state * tileH, tileW, tileH });
+        }
+    }
+
+    return true;
+}
+
+void NoteLabelAtlas::draw (juce::Graphics& g, int pitchClass, State state, juce::Rectangle<float> cellRect) const
+{
+    // Snap to physical pixels so the blit needs no resampling
+    const float scale = params.pixelScale;
+    const float x = std::round ((cellRect.getX() - params.glowMargin) * scale) / scale;
+    const float y = std::round ((cellRect.getY() - params.glowMargin) * scale) / scale;
+
+    g.drawImageTransformed (tiles[state][pitchClass % 12],
+                            juce::AffineTransform::scale (1.0f / scale).translated (x, y));
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Pre-rendered fretboard note cells: one tile per pitch class and colour state,
+// rasterised at the display's pixel scale. Tiles are rebuilt only when the cell
+// size, font, colours or scale change, so painting a cell is a single image blit
+// with no string building or text layout.
+// Shared by the Show Me MIDI and Audio editors.
+class NoteLabelAtlas
+{
+public:
+    enum State { active = 0, root, inScale, outOfScale, chordTone, numStates };
+
+    struct Style
+    {
+        juce::Colour background;
+        juce::Colour text;
+    };
+
+    struct Params
+    {
+        float cellWidth = 0.0f;
+        float cellHeight = 0.0f;
+        float fontHeight = 10.0f;
+        float cornerSize = 3.0f;
+        float glowMargin = 3.0f;        // glow drawn around active cells
+        float glowCornerSize = 4.0f;
+        float pixelScale = 1.0f;
+        Style styles[numStates];
+
+        bool operator== (const Params& o) const;
+    };
+
+    // Returns true if the tiles had to be rebuilt
+    bool prepare (const Params& newParams);
+
+    // Draws the cell for a pitch class at cellRect's position (its size must match the prepared cell size)
+    void draw (juce::Graphics& g, int pitchClass, State state, juce::Rectangle<float> cellRect) const;
+
+private:
+    Params params;
+    juce::Image atlas;
+    juce::Image tiles[numStates][12];
+};
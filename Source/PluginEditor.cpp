@@ -1,40 +1,16 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include <vector>
-#include <climits>
+#include <algorithm>
+#include <cmath>
 
 namespace {
-    const int GUITAR_TUNING[6] = { 64, 59, 55, 50, 45, 40 };
-    const char* NOTE_NAMES[12] = { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
-
-    const char* SCALE_NAMES[] = {
-        "Chromatic", "Major", "Minor", "Harmonic Minor", "Melodic Minor",
-        "Pentatonic Maj", "Pentatonic Min", "Blues", "Dorian", "Phrygian",
-        "Lydian", "Mixolydian", "Locrian", "Whole Tone", "Diminished",
-        "Phrygian Dominant", "Hungarian Minor", "Double Harmonic"
-    };
-    const int NUM_SCALES = 18;
-
-    const int SCALE_PATTERNS[18][12] = {
-        { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
-        { 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1 },
-        { 1, 0, 1, 1, 0, 1, 0, 1, 1, 0, 1, 0 },
-        { 1, 0, 1, 1, 0, 1, 0, 1, 1, 0, 0, 1 },
-        { 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0, 1 },
-        { 1, 0, 1, 0, 1, 0, 0, 1, 0, 1, 0, 0 },
-        { 1, 0, 0, 1, 0, 1, 0, 1, 0, 0, 1, 0 },
-        { 1, 0, 0, 1, 0, 1, 1, 1, 0, 0, 1, 0 },
-        { 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 1, 0 },
-        { 1, 1, 0, 1, 0, 1, 0, 1, 1, 0, 1, 0 },
-        { 1, 0, 1, 0, 1, 0, 1, 1, 0, 1, 0, 1 },
-        { 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 1, 0 },
-        { 1, 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0 },
-        { 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0 },
-        { 1, 0, 1, 1, 0, 1, 1, 0, 1, 1, 0, 1 },
-        { 1, 1, 0, 0, 1, 1, 0, 1, 1, 0, 1, 0 },
-        { 1, 0, 1, 1, 0, 0, 1, 1, 1, 0, 0, 1 },
-        { 1, 1, 0, 0, 1, 1, 0, 1, 1, 0, 0, 1 },
-    };
+    using ShowMe::GUITAR_TUNING;
+    using ShowMe::NotePosition;
+    using ShowMe::NOTE_NAMES;
+    using ShowMe::SCALE_NAMES;
+    using ShowMe::NUM_SCALES;
+    using ShowMe::SCALE_PATTERNS;
 
     juce::String noteNameOnly (int midiNote)
     {
@@ -58,6 +34,7 @@ namespace {
     const juce::Colour nutBone (220, 215, 200);
 
     const int MENU_BAR_HEIGHT = 44;
+    const int STATUS_BAR_HEIGHT = 20;
 }
 
 // Custom LookAndFeel for modern controls
@@ -162,7 +139,8 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
 
     // Position slider
     positionSlider.setRange (0, 18, 1);
-    positionSlider.setValue (0);
+    positionSlider.setValue (processorRef.fretPosition.load());
+    positionSlider.onValueChange = [this] { processorRef.fretPosition.store ((int) positionSlider.getValue()); };
     positionSlider.setSliderStyle (juce::Slider::LinearHorizontal);
     positionSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 28, 20);
     positionSlider.setColour (juce::Slider::textBoxTextColourId, textBright);
@@ -175,7 +153,8 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
 
     // Range slider
     rangeSlider.setRange (3, 8, 1);
-    rangeSlider.setValue (5);
+    rangeSlider.setValue (processorRef.fretRange.load());
+    rangeSlider.onValueChange = [this] { processorRef.fretRange.store ((int) rangeSlider.getValue()); };
     rangeSlider.setSliderStyle (juce::Slider::LinearHorizontal);
     rangeSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 28, 20);
     rangeSlider.setColour (juce::Slider::textBoxTextColourId, textBright);
@@ -188,7 +167,8 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
 
     // Strings slider
     stringsSlider.setRange (4, 8, 1);
-    stringsSlider.setValue (6);
+    stringsSlider.setValue (processorRef.numStrings.load());
+    stringsSlider.onValueChange = [this] { processorRef.numStrings.store ((int) stringsSlider.getValue()); };
     stringsSlider.setSliderStyle (juce::Slider::LinearHorizontal);
     stringsSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 28, 20);
     stringsSlider.setColour (juce::Slider::textBoxTextColourId, textBright);
@@ -201,7 +181,8 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
 
     // Frets slider
     fretsSlider.setRange (12, 24, 1);
-    fretsSlider.setValue (24);
+    fretsSlider.setValue (processorRef.numFrets.load());
+    fretsSlider.onValueChange = [this] { processorRef.numFrets.store ((int) fretsSlider.getValue()); };
     fretsSlider.setSliderStyle (juce::Slider::LinearHorizontal);
     fretsSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 28, 20);
     fretsSlider.setColour (juce::Slider::textBoxTextColourId, textBright);
@@ -212,6 +193,19 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     fretsLabel.setFont (juce::Font (11.0f, juce::Font::bold));
     addAndMakeVisible (fretsLabel);
 
+    // Lookahead clip menu
+    midiButton.setButtonText ("MIDI");
+    midiButton.setColour (juce::TextButton::buttonColourId, controlBg);
+    midiButton.setColour (juce::TextButton::textColourOffId, textDim);
+    midiButton.onClick = [this] { showMidiMenu(); };
+    addAndMakeVisible (midiButton);
+
+    // Key suggestion, shown only when detection disagrees with the selectors
+    keySuggestButton.setColour (juce::TextButton::buttonColourId, controlBg);
+    keySuggestButton.setColour (juce::TextButton::textColourOffId, accentBlue);
+    keySuggestButton.onClick = [this] { applyDetectedKey(); };
+    addChildComponent (keySuggestButton);
+
     setResizable (true, true);
     setResizeLimits (1000, 240, 1800, 500);
     setSize (1200, 300);
@@ -223,62 +217,366 @@ AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor()
     setLookAndFeel (nullptr);
 }
 
-void AudioPluginAudioProcessorEditor::timerCallback() { repaint(); }
+void AudioPluginAudioProcessorEditor::timerCallback()
+{
+    updateKeySuggestion();
+
+    const auto key = getBackgroundKey (lastPixelScale);
+    const bool settingsChanged = key != cachedBackgroundKey;
+    const bool notesChanged = processorRef.getNoteStateVersion() != shownNoteVersion;
+    const bool hasLookahead = ! processorRef.lookaheadClip.isEmpty() && processorRef.hostHasPpq.load();
+
+    // Nothing moved: an idle editor does no painting at all
+    if (! settingsChanged && ! notesChanged && ! hasLookahead && ! hadLookahead)
+        return;
+
+    const auto previousActive = activePositions;
+    const auto previousGhosts = ghostCells;
+    const auto previousLabel = activeNotesLabel;
+    const auto previousChord = currentChord;
+    const int previousHistoryCount = chordHistoryCount;
+
+    updateOverlay (key);
+    hadLookahead = hasLookahead;
+
+    if (settingsChanged)
+    {
+        repaint();
+        return;
+    }
+
+    // Only the cells whose overlay changed, plus the label and status bar when they did
+    const auto layout = getFretboardLayout (key.numStrings, key.numFrets);
+    auto repaintCell = [&] (int stringIndex, int fret)
+    {
+        repaint (layout.getNoteRect (stringIndex, fret).expanded (4.0f).getSmallestIntegerContainer());
+    };
+
+    auto samePosition = [] (const NotePosition& a, const NotePosition& b)
+    {
+        return a.stringIndex == b.stringIndex && a.fret == b.fret && a.midiNote == b.midiNote;
+    };
+    auto sameGhost = [] (const GhostCell& a, const GhostCell& b)
+    {
+        return a.stringIndex == b.stringIndex && a.fret == b.fret && a.alpha == b.alpha;
+    };
+
+    for (const auto& p : previousActive)
+        if (std::none_of (activePositions.begin(), activePositions.end(), [&] (const NotePosition& q) { return samePosition (p, q); }))
+            repaintCell (p.stringIndex, p.fret);
+    for (const auto& p : activePositions)
+        if (std::none_of (previousActive.begin(), previousActive.end(), [&] (const NotePosition& q) { return samePosition (p, q); }))
+            repaintCell (p.stringIndex, p.fret);
+
+    for (const auto& c : previousGhosts)
+        if (std::none_of (ghostCells.begin(), ghostCells.end(), [&] (const GhostCell& q) { return sameGhost (c, q); }))
+            repaintCell (c.stringIndex, c.fret);
+    for (const auto& c : ghostCells)
+        if (std::none_of (previousGhosts.begin(), previousGhosts.end(), [&] (const GhostCell& q) { return sameGhost (c, q); }))
+            repaintCell (c.stringIndex, c.fret);
+
+    if (activeNotesLabel != previousLabel)
+        repaint (getActiveLabelBounds());
+
+    if (currentChord != previousChord || chordHistoryCount != previousHistoryCount)
+        repaint (getStatusBarBounds());
+}
+
+void AudioPluginAudioProcessorEditor::updateOverlay (const BackgroundKey& key)
+{
+    uint32_t version = 0;
+    const auto notes = processorRef.getActiveNotes (version);
+    shownNoteVersion = version;
+
+    updateChord (notes);
+
+    // Active notes label and optimal positions
+    activeNotesLabel.clear();
+    activePositions.clear();
+    notes.forEachNote ([&] (int n)
+    {
+        if (activeNotesLabel.isNotEmpty()) activeNotesLabel += " ";
+        activeNotesLabel += noteNameOnly (n);
+
+        auto pos = fingering.findOptimalPosition (n, key.position, key.range, key.numStrings, key.numFrets);
+        if (pos.stringIndex >= 0)
+        {
+            activePositions.push_back (pos);
+            if (activePositions.size() == 1) fingering.moveTo (pos);
+        }
+    });
+
+    // Upcoming notes from the loaded clip, fingered in order from the current hand position
+    ghostCells.clear();
+    if (! processorRef.lookaheadClip.isEmpty() && processorRef.hostHasPpq.load())
+    {
+        const double now = processorRef.hostPpq.load();
+        const double ahead = (double) processorRef.lookaheadBeats.load();
+        ShowMe::Fingering reader = fingering;
+
+        processorRef.lookaheadClip.forEachNoteStartingIn (now, now + ahead, [&] (const LookaheadClip::Note& n)
+        {
+            auto pos = reader.findOptimalPosition (n.midiNote, key.position, key.range, key.numStrings, key.numFrets);
+            if (pos.stringIndex < 0)
+                return;
+
+            reader.moveTo (pos);
+
+            // Nearer notes drawn stronger; quantised so cells only repaint on visible steps
+            float alpha = 0.85f - 0.65f * (float) ((n.startBeat - now) / ahead);
+            ghostCells.push_back ({ pos.stringIndex, pos.fret, std::round (alpha * 20.0f) / 20.0f });
+        });
+    }
+}
+
+juce::Rectangle<int> AudioPluginAudioProcessorEditor::getActiveLabelBounds() const
+{
+    return getLocalBounds().removeFromTop (MENU_BAR_HEIGHT).removeFromRight (100);
+}
+
+juce::Rectangle<int> AudioPluginAudioProcessorEditor::getStatusBarBounds() const
+{
+    return getLocalBounds().removeFromBottom (STATUS_BAR_HEIGHT);
+}
+
+void AudioPluginAudioProcessorEditor::updateKeySuggestion()
+{
+    const int mode = processorRef.keyDetectMode.load();
+    const int key = processorRef.detectedKey.load();
+    const int scale = processorRef.detectedScale.load();
+
+    const bool valid = mode != AudioPluginAudioProcessor::keyDetectOff && key >= 0 && scale >= 0;
+    const bool differs = valid && (keySelector.getSelectedId() != key + 1 || scaleSelector.getSelectedId() != scale + 1);
+
+    if (differs && mode == AudioPluginAudioProcessor::keyDetectAutoApply)
+        applyDetectedKey();
+
+    const bool suggest = differs && mode == AudioPluginAudioProcessor::keyDetectSuggest;
+    if (suggest)
+        keySuggestButton.setButtonText ("Detected " + juce::String (NOTE_NAMES[key]) + " " + SCALE_NAMES[scale] + " - apply");
+    keySuggestButton.setVisible (suggest);
+}
+
+void AudioPluginAudioProcessorEditor::applyDetectedKey()
+{
+    const int key = processorRef.detectedKey.load();
+    const int scale = processorRef.detectedScale.load();
+    if (key < 0 || scale < 0)
+        return;
+
+    keySelector.setSelectedId (key + 1);
+    scaleSelector.setSelectedId (scale + 1);
+    keySuggestButton.setVisible (false);
+}
 
 void AudioPluginAudioProcessorEditor::setControlsVisible (bool) {}
 
 void AudioPluginAudioProcessorEditor::mouseDown (const juce::MouseEvent&) {}
 
+void AudioPluginAudioProcessorEditor::showMidiMenu()
+{
+    const auto& clip = processorRef.lookaheadClip;
+    const int currentBeats = processorRef.lookaheadBeats.load();
+
+    juce::PopupMenu aheadMenu;
+    for (int beats : { 1, 2, 4, 8, 16 })
+        aheadMenu.addItem (100 + beats, juce::String (beats) + (beats == 1 ? " beat" : " beats"),
+                           true, beats == currentBeats);
+
+    const int detectMode = processorRef.keyDetectMode.load();
+    juce::PopupMenu keyMenu;
+    keyMenu.addItem (200 + AudioPluginAudioProcessor::keyDetectOff, "Off", true, detectMode == AudioPluginAudioProcessor::keyDetectOff);
+    keyMenu.addItem (200 + AudioPluginAudioProcessor::keyDetectSuggest, "Suggest", true, detectMode == AudioPluginAudioProcessor::keyDetectSuggest);
+    keyMenu.addItem (200 + AudioPluginAudioProcessor::keyDetectAutoApply, "Auto-apply", true, detectMode == AudioPluginAudioProcessor::keyDetectAutoApply);
+
+    juce::PopupMenu menu;
+    menu.addItem (1, "Load MIDI clip...");
+    menu.addItem (2, "Clear clip", ! clip.isEmpty());
+    menu.addSubMenu ("Look ahead", aheadMenu);
+    menu.addSeparator();
+    menu.addItem (4, "Channel per string output", true, processorRef.channelPerString.load());
+    menu.addSubMenu ("Key detection", keyMenu);
+    if (! clip.isEmpty())
+    {
+        menu.addSeparator();
+        menu.addItem (3, clip.getFile().getFileName() + " (" + juce::String (clip.getNumNotes()) + " notes)", false);
+    }
+
+    menu.showMenuAsync (juce::PopupMenu::Options().withTargetComponent (&midiButton),
+        [this] (int result)
+        {
+            if (result == 1)
+                loadLookaheadClip();
+            else if (result == 2)
+                processorRef.lookaheadClip.clear();
+            else if (result == 4)
+                processorRef.channelPerString.store (! processorRef.channelPerString.load());
+            else if (result >= 200)
+                processorRef.keyDetectMode.store (result - 200);
+            else if (result > 100)
+                processorRef.lookaheadBeats.store (result - 100);
+
+            repaint();
+        });
+}
+
+void AudioPluginAudioProcessorEditor::loadLookaheadClip()
+{
+    clipChooser = std::make_unique<juce::FileChooser> ("Load MIDI clip", processorRef.lookaheadClip.getFile(), "*.mid;*.midi");
+    clipChooser->launchAsync (juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+        [this] (const juce::FileChooser& chooser)
+        {
+            auto file = chooser.getResult();
+            if (file == juce::File())
+                return;
+
+            auto error = processorRef.lookaheadClip.loadFromFile (file);
+            if (error.isNotEmpty())
+                juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon, "Show Me", error);
+
+            repaint();
+        });
+}
+
 bool AudioPluginAudioProcessorEditor::isNoteInScale (int midiNote, int root, int scaleIndex)
 {
     int interval = (midiNote - root + 120) % 12;
     return SCALE_PATTERNS[scaleIndex][interval] == 1;
 }
 
-AudioPluginAudioProcessorEditor::NotePosition AudioPluginAudioProcessorEditor::findOptimalPosition (
-    int midiNote, int preferredPosition, int fingerRange, int numStrings, int totalFrets)
+AudioPluginAudioProcessorEditor::BackgroundKey AudioPluginAudioProcessorEditor::getBackgroundKey (float pixelScale) const
 {
-    struct Candidate { int s; int f; int d; bool z; };
-    std::vector<Candidate> c;
+    BackgroundKey k;
+    k.key = keySelector.getSelectedId() - 1;
+    k.scale = scaleSelector.getSelectedId() - 1;
+    k.position = (int) positionSlider.getValue();
+    k.range = (int) rangeSlider.getValue();
+    k.numStrings = (int) stringsSlider.getValue();
+    k.numFrets = (int) fretsSlider.getValue();
+    k.width = getWidth();
+    k.height = getHeight();
+    k.pixelScale = pixelScale;
+    return k;
+}
 
-    for (int s = 0; s < numStrings; ++s)
-    {
-        int f = midiNote - GUITAR_TUNING[s];
-        if (f >= 0 && f <= totalFrets)
-        {
-            int d = std::abs(s - currentString) + std::abs(f - currentFret);
-            bool z = (f >= preferredPosition && f <= preferredPosition + fingerRange - 1);
-            c.push_back({s, f, d, z});
-        }
-    }
+AudioPluginAudioProcessorEditor::FretboardLayout AudioPluginAudioProcessorEditor::getFretboardLayout (int numStrings, int numFrets) const
+{
+    // Fretboard area - explicitly below menu bar with gap
+    const int fretboardTop = MENU_BAR_HEIGHT + 6;
+    const int padding = 10;
+    const int fretNumSpace = 16;
+
+    // Fixed note sizes
+    const float fixedNoteH = 22.0f;
+    const float fixedStringSpacing = 28.0f;
+    float fretboardHeight = fixedStringSpacing * (numStrings - 1) + fixedNoteH;
 
-    if (c.empty()) return {-1, -1, midiNote};
+    // Calculate fretboard bounds - vertically center
+    int availableHeight = getHeight() - fretboardTop - fretNumSpace - 4 - STATUS_BAR_HEIGHT;
+    int yOffset = (availableHeight - (int)fretboardHeight) / 2;
+    if (yOffset < 0) yOffset = 0;
 
-    Candidate* best = nullptr;
-    int bestD = INT_MAX;
-    for (auto& x : c) if (x.z && x.d < bestD) { bestD = x.d; best = &x; }
-    if (!best) for (auto& x : c) if (x.d < bestD) { bestD = x.d; best = &x; }
+    FretboardLayout layout;
+    layout.fretArea = { padding, fretboardTop + yOffset, getWidth() - padding * 2, (int) fretboardHeight };
+    layout.stringSpacing = fixedStringSpacing;
+    layout.fretWidth = (float) layout.fretArea.getWidth() / (numFrets + 1);
+    layout.noteW = juce::jmin (layout.fretWidth * 0.85f, 28.0f);
+    layout.noteH = fixedNoteH;
 
-    return {best->s, best->f, midiNote};
+    // Notes are positioned so first row starts at top of fretArea + half note height
+    layout.firstNoteY = layout.fretArea.getY() + layout.noteH / 2.0f;
+    return layout;
+}
+
+void AudioPluginAudioProcessorEditor::prepareNoteAtlas (const BackgroundKey& k)
+{
+    const auto layout = getFretboardLayout (k.numStrings, k.numFrets);
+
+    NoteLabelAtlas::Params params;
+    params.cellWidth = layout.noteW;
+    params.cellHeight = layout.noteH;
+    params.fontHeight = 10.0f;
+    params.cornerSize = 3.0f;
+    params.glowMargin = 3.0f;
+    params.glowCornerSize = 4.0f;
+    params.pixelScale = k.pixelScale;
+    params.styles[NoteLabelAtlas::active]     = { activeNote, bgDark };
+    params.styles[NoteLabelAtlas::root]       = { rootNote, textBright };
+    params.styles[NoteLabelAtlas::inScale]    = { scaleNote, textBright };
+    params.styles[NoteLabelAtlas::outOfScale] = { outOfScale, textDim.withAlpha (0.5f) };
+    noteAtlas.prepare (params);
+}
+
+juce::Rectangle<float> AudioPluginAudioProcessorEditor::FretboardLayout::getNoteRect (int stringIndex, int fret) const
+{
+    float x = fretArea.getX() + (fret + 0.5f) * fretWidth;
+    float y = firstNoteY + stringIndex * stringSpacing;
+    return { x - noteW / 2, y - noteH / 2, noteW, noteH };
 }
 
 void AudioPluginAudioProcessorEditor::paint (juce::Graphics& g)
 {
-    g.fillAll (bgDark);
+    // Static layer: only re-rendered when a setting, the size or the display scale changes
+    const float pixelScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    lastPixelScale = pixelScale;
+    const auto backgroundKey = getBackgroundKey (pixelScale);
+    if (backgroundCache.isNull() || backgroundKey != cachedBackgroundKey)
+    {
+        backgroundCache = juce::Image (juce::Image::RGB,
+                                       juce::jmax (1, juce::roundToInt (getWidth() * pixelScale)),
+                                       juce::jmax (1, juce::roundToInt (getHeight() * pixelScale)), false);
+        prepareNoteAtlas (backgroundKey);
+        juce::Graphics bg (backgroundCache);
+        bg.addTransform (juce::AffineTransform::scale (pixelScale));
+        renderBackground (bg, backgroundKey);
+        cachedBackgroundKey = backgroundKey;
+    }
+    g.drawImage (backgroundCache, getLocalBounds().toFloat());
+
+    // Active notes display on the right
+    if (activeNotesLabel.isNotEmpty() && g.clipRegionIntersects (getActiveLabelBounds()))
+    {
+        g.setColour (activeNote);
+        g.setFont (juce::Font (16.0f, juce::Font::bold));
+        g.drawText (activeNotesLabel, getActiveLabelBounds().reduced (8, 0),
+                    juce::Justification::centredRight);
+    }
 
-    const int position = (int) positionSlider.getValue();
-    const int range = (int) rangeSlider.getValue();
-    const int key = keySelector.getSelectedId() - 1;
-    const int scale = scaleSelector.getSelectedId() - 1;
+    const auto layout = getFretboardLayout (backgroundKey.numStrings, backgroundKey.numFrets);
 
-    std::set<int> activeNotes;
+    // Ghosted outlines for notes coming up in the clip
+    for (const auto& c : ghostCells)
     {
-        std::lock_guard<std::mutex> lock (processorRef.notesMutex);
-        activeNotes = processorRef.activeNotes;
+        auto noteRect = layout.getNoteRect (c.stringIndex, c.fret).expanded (1.5f);
+        if (! g.clipRegionIntersects (noteRect.getSmallestIntegerContainer().expanded (2)))
+            continue;
+
+        g.setColour (activeNote.withAlpha (c.alpha));
+        g.drawRoundedRectangle (noteRect, 4.0f, 2.0f);
     }
 
-    const int numStrings = (int) stringsSlider.getValue();
-    const int numFrets = (int) fretsSlider.getValue();
+    // Active notes on top of the cached cells
+    for (const auto& p : activePositions)
+    {
+        auto noteRect = layout.getNoteRect (p.stringIndex, p.fret);
+        if (g.clipRegionIntersects (noteRect.expanded (3).getSmallestIntegerContainer()))
+            noteAtlas.draw (g, p.midiNote % 12, NoteLabelAtlas::active, noteRect);
+    }
+
+    if (g.clipRegionIntersects (getStatusBarBounds()))
+        drawStatusBar (g);
+}
+
+void AudioPluginAudioProcessorEditor::renderBackground (juce::Graphics& g, const BackgroundKey& k)
+{
+    g.fillAll (bgDark);
+
+    const int position = k.position;
+    const int range = k.range;
+    const int key = k.key;
+    const int scale = k.scale;
+    const int numStrings = k.numStrings;
+    const int numFrets = k.numFrets;
 
     // Menu bar background
     auto menuBar = getLocalBounds().removeFromTop (MENU_BAR_HEIGHT);
@@ -327,41 +625,9 @@ void AudioPluginAudioProcessorEditor::paint (juce::Graphics& g)
         g.drawText (juce::String (NOTE_NAMES[noteIndex]), noteBox, juce::Justification::centred, false);
     }
 
-    // Active notes display on the right
-    if (!activeNotes.empty())
-    {
-        juce::String noteStr;
-        for (int n : activeNotes)
-        {
-            if (!noteStr.isEmpty()) noteStr += " ";
-            noteStr += noteNameOnly (n);
-        }
-        g.setColour (activeNote);
-        g.setFont (juce::Font (16.0f, juce::Font::bold));
-        g.drawText (noteStr, menuBar.removeFromRight (100).reduced (8, 0),
-                    juce::Justification::centredRight);
-    }
-
-    // Fretboard area - explicitly below menu bar with gap
-    const int fretboardTop = MENU_BAR_HEIGHT + 6;
-    const int padding = 10;
-    const int fretNumSpace = 16;
-
-    // Fixed note sizes
-    const float fixedNoteH = 22.0f;
-    const float fixedStringSpacing = 28.0f;
-    float fretboardHeight = fixedStringSpacing * (numStrings - 1) + fixedNoteH;
-
-    // Calculate fretboard bounds - vertically center
-    int availableHeight = getHeight() - fretboardTop - fretNumSpace - 4;
-    int yOffset = (availableHeight - (int)fretboardHeight) / 2;
-    if (yOffset < 0) yOffset = 0;
-
-    juce::Rectangle<int> fretArea (padding, fretboardTop + yOffset,
-                                    getWidth() - padding * 2, (int)fretboardHeight);
-
-    float stringSpacing = fixedStringSpacing;
-    float fretWidth = (float) fretArea.getWidth() / (numFrets + 1);
+    const auto layout = getFretboardLayout (numStrings, numFrets);
+    const auto& fretArea = layout.fretArea;
+    const float fretWidth = layout.fretWidth;
 
     // Fretboard wood background
     g.setColour (fretboardCol);
@@ -397,73 +663,23 @@ void AudioPluginAudioProcessorEditor::paint (juce::Graphics& g)
         g.drawLine (x, fretAreaY, x, fretAreaY + fretAreaH, 1.0f);
     }
 
-    // Get optimal positions for active notes
-    std::vector<NotePosition> optimalPos;
-    for (int n : activeNotes)
-    {
-        auto pos = findOptimalPosition (n, position, range, numStrings, numFrets);
-        if (pos.stringIndex >= 0)
-        {
-            optimalPos.push_back (pos);
-            if (optimalPos.size() == 1) { currentString = pos.stringIndex; currentFret = pos.fret; }
-        }
-    }
-
-    // Draw notes - set font ONCE before loop to prevent layout shifts
-    float noteW = juce::jmin (fretWidth * 0.85f, 28.0f);
-    float noteH = fixedNoteH;
-    juce::Font noteFont (10.0f);
-    g.setFont (noteFont);
-
-    // Notes are positioned so first row starts at top of fretArea + half note height
-    float firstNoteY = fretAreaY + noteH / 2.0f;
-
+    // Note cells come pre-rendered from the atlas
     for (int s = 0; s < numStrings; ++s)
     {
-        float y = firstNoteY + s * stringSpacing;
         int openNote = GUITAR_TUNING[s];
 
         for (int f = 0; f <= numFrets; ++f)
         {
             int midi = openNote + f;
-            float x = fretArea.getX() + (f + 0.5f) * fretWidth;
             int noteClass = midi % 12;
 
-            bool isActive = false;
-            for (auto& p : optimalPos)
-                if (p.stringIndex == s && p.fret == f) { isActive = true; break; }
-
-            bool isRoot = (noteClass == key);
-            bool inScale = isNoteInScale (midi, key, scale);
-
-            juce::Colour bg, fg;
-            if (isActive) {
-                bg = activeNote;
-                fg = bgDark;
-            } else if (isRoot) {
-                bg = rootNote;
-                fg = textBright;
-            } else if (inScale) {
-                bg = scaleNote;
-                fg = textBright;
-            } else {
-                bg = outOfScale;
-                fg = textDim.withAlpha (0.5f);
-            }
-
-            juce::Rectangle<float> noteRect (x - noteW/2, y - noteH/2, noteW, noteH);
-
-            if (isActive)
-            {
-                g.setColour (activeNote.withAlpha (0.4f));
-                g.fillRoundedRectangle (noteRect.expanded (3), 4.0f);
-            }
-
-            g.setColour (bg);
-            g.fillRoundedRectangle (noteRect, 3.0f);
-
-            g.setColour (fg);
-            g.drawText (noteNameOnly (midi), noteRect, juce::Justification::centred, false);
+            auto state = NoteLabelAtlas::outOfScale;
+            if (noteClass == key)
+                state = NoteLabelAtlas::root;
+            else if (isNoteInScale (midi, key, scale))
+                state = NoteLabelAtlas::inScale;
+
+            noteAtlas.draw (g, noteClass, state, layout.getNoteRect (s, f));
         }
     }
 
@@ -478,6 +694,68 @@ void AudioPluginAudioProcessorEditor::paint (juce::Graphics& g)
     }
 }
 
+void AudioPluginAudioProcessorEditor::updateChord (const AudioPluginAudioProcessor::NoteSnapshot& notes)
+{
+    // Two or more notes: one table lookup on the pitch-class mask, using the lowest note as bass
+    unsigned mask = 0;
+    int count = 0, lowest = -1;
+    notes.forEachNote ([&] (int n)
+    {
+        mask |= 1u << (n % 12);
+        if (lowest < 0) lowest = n;
+        ++count;
+    });
+
+    ShowMe::Chord chord;
+    if (count >= 2)
+        chord = ShowMe::recogniseChord (mask, lowest % 12);
+
+    currentChord = chord;
+    if (! chord.isValid())
+        return;
+
+    const int newest = (chordHistoryCount - 1 + CHORD_HISTORY_SIZE) % CHORD_HISTORY_SIZE;
+    if (chordHistoryCount > 0 && chordHistory[newest] == chord)
+        return;
+
+    chordHistory[chordHistoryCount % CHORD_HISTORY_SIZE] = chord;
+    ++chordHistoryCount;
+}
+
+void AudioPluginAudioProcessorEditor::drawStatusBar (juce::Graphics& g)
+{
+    auto statusBar = getLocalBounds().removeFromBottom (STATUS_BAR_HEIGHT).reduced (12, 1);
+    char name[32];
+
+    g.setColour (textDim);
+    g.setFont (juce::Font (11.0f, juce::Font::bold));
+    g.drawText ("CHORD", statusBar.removeFromLeft (48), juce::Justification::centredLeft);
+
+    ShowMe::formatChord (currentChord, name, (int) sizeof (name));
+    g.setColour (currentChord.isValid() ? activeNote : textDim);
+    g.setFont (juce::Font (14.0f, juce::Font::bold));
+    g.drawText (name, statusBar.removeFromLeft (80), juce::Justification::centredLeft);
+
+    // History strip, newest first and fading out
+    g.setFont (juce::Font (11.0f));
+    const int shown = juce::jmin (chordHistoryCount, CHORD_HISTORY_SIZE);
+    for (int i = 0; i < shown; ++i)
+    {
+        const auto& chord = chordHistory[(chordHistoryCount - 1 - i) % CHORD_HISTORY_SIZE];
+        auto chip = statusBar.removeFromLeft (58).reduced (2, 1).toFloat();
+        if (chip.getWidth() <= 0.0f)
+            break;
+
+        const float alpha = 1.0f - 0.1f * (float) i;
+        g.setColour (controlBg.withAlpha (alpha));
+        g.fillRoundedRectangle (chip, 3.0f);
+
+        ShowMe::formatChord (chord, name, (int) sizeof (name));
+        g.setColour (textBright.withAlpha (alpha * 0.8f));
+        g.drawText (name, chip, juce::Justification::centred);
+    }
+}
+
 void AudioPluginAudioProcessorEditor::resized()
 {
     auto bounds = getLocalBounds();
@@ -520,4 +798,12 @@ void AudioPluginAudioProcessorEditor::resized()
     // Frets
     fretsLabel.setBounds (x, y, 50, labelH);
     fretsSlider.setBounds (x, y + labelH, 100, ctrlH);
+    x += 110;
+
+    // Lookahead clip menu
+    midiButton.setBounds (x, y + labelH, 56, ctrlH);
+
+    // Status bar along the bottom
+    auto statusBar = getLocalBounds().removeFromBottom (STATUS_BAR_HEIGHT).reduced (12, 1);
+    keySuggestButton.setBounds (statusBar.removeFromRight (240));
 }
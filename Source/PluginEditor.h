@@ -1,6 +1,11 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include "Fingering.h"
+#include "Scales.h"
+#include "ChordTable.h"
+#include "NoteLabelAtlas.h"
+#include <vector>
 
 class AudioPluginAudioProcessorEditor  : public juce::AudioProcessorEditor,
                                          private juce::Timer
@@ -36,20 +41,84 @@ private:
     juce::Label keyLabel;
     juce::Label scaleLabel;
 
-    // Current finger position for optimal note selection
-    int currentString = 2;
-    int currentFret = 5;
+    // Lookahead clip menu
+    juce::TextButton midiButton;
+    std::unique_ptr<juce::FileChooser> clipChooser;
+
+    // Offers the detected key/scale in the status bar
+    juce::TextButton keySuggestButton;
+
+    // Chord naming, with the most recent distinct chords shown in the status bar
+    static constexpr int CHORD_HISTORY_SIZE = 8;
+    ShowMe::Chord currentChord;
+    ShowMe::Chord chordHistory[CHORD_HISTORY_SIZE];
+    int chordHistoryCount = 0;
+
+    // Geometry of the fretboard for the current size and string count
+    struct FretboardLayout
+    {
+        juce::Rectangle<int> fretArea;
+        float fretWidth = 0.0f;
+        float stringSpacing = 0.0f;
+        float noteW = 0.0f;
+        float noteH = 0.0f;
+        float firstNoteY = 0.0f;
+
+        juce::Rectangle<float> getNoteRect (int stringIndex, int fret) const;
+    };
 
-    struct NotePosition {
+    // Everything the static background depends on; a change triggers a re-render
+    struct BackgroundKey
+    {
+        int key = -1, scale = -1, position = -1, range = -1, numStrings = -1, numFrets = -1;
+        int width = 0, height = 0;
+        float pixelScale = 0.0f;
+
+        bool operator!= (const BackgroundKey& o) const
+        {
+            return key != o.key || scale != o.scale || position != o.position || range != o.range
+                || numStrings != o.numStrings || numFrets != o.numFrets
+                || width != o.width || height != o.height || pixelScale != o.pixelScale;
+        }
+    };
+
+    // Cached fretboard, scale panel and bars; each frame only adds the note overlays
+    juce::Image backgroundCache;
+    BackgroundKey cachedBackgroundKey;
+    NoteLabelAtlas noteAtlas;
+
+    // Note overlays, recomputed by the timer only when notes, settings or the lookahead change
+    struct GhostCell
+    {
         int stringIndex;
         int fret;
-        int midiNote;
+        float alpha;
     };
+    std::vector<ShowMe::NotePosition> activePositions;
+    std::vector<GhostCell> ghostCells;
+    juce::String activeNotesLabel;
+    uint32_t shownNoteVersion = ~0u;
+    bool hadLookahead = false;
+    float lastPixelScale = 1.0f;
+
+    // Current finger position for optimal note selection
+    ShowMe::Fingering fingering;
 
-    NotePosition findOptimalPosition (int midiNote, int preferredPosition, int fingerRange,
-                                      int numStrings, int totalFrets);
     bool isNoteInScale (int midiNote, int root, int scaleIndex);
     void setControlsVisible (bool visible);
+    void showMidiMenu();
+    void loadLookaheadClip();
+    void updateKeySuggestion();
+    void applyDetectedKey();
+    void updateChord (const AudioPluginAudioProcessor::NoteSnapshot& notes);
+    void drawStatusBar (juce::Graphics& g);
+    BackgroundKey getBackgroundKey (float pixelScale) const;
+    FretboardLayout getFretboardLayout (int numStrings, int numFrets) const;
+    void renderBackground (juce::Graphics& g, const BackgroundKey& k);
+    void prepareNoteAtlas (const BackgroundKey& k);
+    void updateOverlay (const BackgroundKey& key);
+    juce::Rectangle<int> getActiveLabelBounds() const;
+    juce::Rectangle<int> getStatusBarBounds() const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessorEditor)
 };
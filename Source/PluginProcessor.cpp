@@ -1,5 +1,11 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include <cstring>
+
+namespace {
+    // Reserved up front so rewriting a dense block never grows the buffer on the audio thread
+    const int STRING_MIDI_BUFFER_BYTES = 32768;
+}
 
 AudioPluginAudioProcessor::AudioPluginAudioProcessor()
      : AudioProcessor (BusesProperties()
@@ -11,6 +17,7 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
                      #endif
                        )
 {
+    std::memset (noteString, -1, sizeof (noteString));
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
@@ -83,6 +90,94 @@ void AudioPluginAudioProcessor::changeProgramName (int index, const juce::String
 void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
     juce::ignoreUnused (sampleRate, samplesPerBlock);
+
+    stringChannelMidi.ensureSize (STRING_MIDI_BUFFER_BYTES);
+    std::memset (noteString, -1, sizeof (noteString));
+    std::fill (std::begin (stringNoteCount), std::end (stringNoteCount), 0);
+    outputFingering.reset();
+    wasRewriting = false;
+}
+
+void AudioPluginAudioProcessor::updateActiveNotes (const juce::MidiBuffer& midiMessages)
+{
+    uint32_t bits[4];
+    for (int i = 0; i < 4; ++i)
+        bits[i] = noteBits[i].load (std::memory_order_relaxed);
+
+    for (const auto metadata : midiMessages)
+    {
+        const juce::uint8* raw = metadata.data;
+        if (metadata.numBytes < 3)
+            continue;
+
+        const int status = raw[0] & 0xf0;
+        const int note = raw[1] & 0x7f;
+
+        if (status == 0x90 && raw[2] > 0)
+            bits[note >> 5] |= 1u << (note & 31);
+        else if (status == 0x80 || status == 0x90)
+            bits[note >> 5] &= ~(1u << (note & 31));
+        else if (status == 0xb0 && (raw[1] == 120 || raw[1] == 123))
+            bits[0] = bits[1] = bits[2] = bits[3] = 0;
+    }
+
+    bool changed = false;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (bits[i] != noteBits[i].load (std::memory_order_relaxed))
+        {
+            noteBits[i].store (bits[i], std::memory_order_relaxed);
+            changed = true;
+        }
+    }
+
+    if (changed)
+        noteStateVersion.fetch_add (1, std::memory_order_release);
+}
+
+AudioPluginAudioProcessor::NoteSnapshot AudioPluginAudioProcessor::getActiveNotes (uint32_t& version) const
+{
+    // Re-read if the audio thread published a change part way through
+    NoteSnapshot snapshot;
+    for (int attempt = 0; attempt < 4; ++attempt)
+    {
+        version = noteStateVersion.load (std::memory_order_acquire);
+        for (int i = 0; i < 4; ++i)
+            snapshot.bits[i] = noteBits[i].load (std::memory_order_acquire);
+
+        if (noteStateVersion.load (std::memory_order_acquire) == version)
+            break;
+    }
+    return snapshot;
+}
+
+void AudioPluginAudioProcessor::updateKeyDetection (const juce::MidiBuffer& midiMessages, int numSamples)
+{
+    if (keyDetectMode.load() == keyDetectOff)
+        return;
+
+    bool anyNotes = false;
+    for (const auto metadata : midiMessages)
+    {
+        const juce::uint8* raw = metadata.data;
+        if (metadata.numBytes >= 3 && (raw[0] & 0xf0) == 0x90 && raw[2] > 0)
+        {
+            keyDetector.addNote (raw[1] & 0x7f, raw[2]);
+            anyNotes = true;
+        }
+    }
+
+    const double sampleRate = getSampleRate();
+    if (sampleRate > 0.0)
+        keyDetector.advance (numSamples / sampleRate);
+
+    // Scoring runs at most once per block however dense the input is
+    if (anyNotes)
+    {
+        auto match = keyDetector.update();
+        detectedKey.store (match.key);
+        detectedScale.store (match.scale);
+    }
 }
 
 void AudioPluginAudioProcessor::releaseResources()
@@ -113,27 +208,156 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // Follow the host playhead so the editor can show what is coming up
+    if (auto* playHead = getPlayHead())
     {
-        std::lock_guard<std::mutex> lock (notesMutex);
-        for (const auto metadata : midiMessages)
+        if (auto position = playHead->getPosition())
         {
-            auto message = metadata.getMessage();
+            auto ppq = position->getPpqPosition();
+            hostHasPpq.store (ppq.hasValue());
+            if (ppq.hasValue())
+                hostPpq.store (*ppq);
+            hostIsPlaying.store (position->getIsPlaying());
+        }
+    }
+
+    updateActiveNotes (midiMessages);
+    updateKeyDetection (midiMessages, buffer.getNumSamples());
+    rewriteToStringChannels (midiMessages);
 
-            if (message.isNoteOn())
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+}
+
+void AudioPluginAudioProcessor::rewriteToStringChannels (juce::MidiBuffer& midiMessages)
+{
+    const bool rewrite = channelPerString.load();
+
+    if (! rewrite)
+    {
+        // Switched off mid-performance: stop anything still held on a string channel
+        if (wasRewriting)
+        {
+            releaseStringChannels (midiMessages, 0);
+            wasRewriting = false;
+        }
+        return;
+    }
+
+    wasRewriting = true;
+    stringChannelMidi.clear();
+
+    const int position = fretPosition.load();
+    const int range = fretRange.load();
+    const int strings = juce::jlimit (1, ShowMe::MAX_STRINGS, numStrings.load());
+    const int frets = numFrets.load();
+
+    // Every event costs at most one fingering pass over the strings plus
+    // one copy per string channel, so dense blocks stay bounded
+    for (const auto metadata : midiMessages)
+    {
+        const juce::uint8* raw = metadata.data;
+        const int numBytes = metadata.numBytes;
+        const int pos = metadata.samplePosition;
+
+        const int status = raw[0] & 0xf0;
+        if (numBytes < 2 || raw[0] >= 0xf0)
+        {
+            stringChannelMidi.addEvent (raw, numBytes, pos);
+            continue;
+        }
+
+        const int channel = raw[0] & 0x0f;
+        juce::uint8 out[3] = { raw[0], raw[1], numBytes > 2 ? raw[2] : (juce::uint8) 0 };
+        auto sendOnString = [&] (int stringIndex)
+        {
+            out[0] = (juce::uint8) (status | stringIndex);
+            stringChannelMidi.addEvent (out, numBytes, pos);
+        };
+
+        const bool isNoteOn = status == 0x90 && numBytes > 2 && raw[2] > 0;
+        const bool isNoteOff = status == 0x80 || (status == 0x90 && ! isNoteOn);
+
+        if (isNoteOn)
+        {
+            const int note = raw[1] & 0x7f;
+            int s = noteString[channel][note];
+
+            // A repeated note-on keeps its string; a new one avoids strings already ringing
+            if (s < 0)
             {
-                activeNotes.insert (message.getNoteNumber());
+                unsigned used = 0;
+                for (int i = 0; i < ShowMe::MAX_STRINGS; ++i)
+                    if (stringNoteCount[i] > 0) used |= 1u << i;
+
+                auto fingered = outputFingering.findOptimalPosition (note, position, range, strings, frets, used);
+                s = fingered.stringIndex;
+                if (s >= 0)
+                {
+                    outputFingering.moveTo (fingered);
+                    noteString[channel][note] = (int8_t) s;
+                    ++stringNoteCount[s];
+                }
             }
-            else if (message.isNoteOff())
+
+            if (s >= 0) sendOnString (s);
+            else stringChannelMidi.addEvent (raw, numBytes, pos);
+        }
+        else if (isNoteOff || status == 0xa0)
+        {
+            const int note = raw[1] & 0x7f;
+            const int s = noteString[channel][note];
+
+            if (s >= 0)
             {
-                activeNotes.erase (message.getNoteNumber());
+                sendOnString (s);
+                if (isNoteOff)
+                {
+                    noteString[channel][note] = -1;
+                    --stringNoteCount[s];
+                }
+            }
+            else
+            {
+                stringChannelMidi.addEvent (raw, numBytes, pos);
+            }
+        }
+        else
+        {
+            // Channel-wide messages (CC, bend, pressure, program) go to every string
+            for (int i = 0; i < strings; ++i)
+                sendOnString (i);
+
+            const bool allNotesOff = status == 0xb0 && (raw[1] == 120 || raw[1] == 123);
+            if (allNotesOff)
+            {
+                for (int note = 0; note < 128; ++note)
+                {
+                    const int s = noteString[channel][note];
+                    if (s >= 0)
+                    {
+                        --stringNoteCount[s];
+                        noteString[channel][note] = -1;
+                    }
+                }
             }
         }
     }
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
+    midiMessages.swapWith (stringChannelMidi);
+}
+
+void AudioPluginAudioProcessor::releaseStringChannels (juce::MidiBuffer& out, int samplePosition)
+{
+    for (int s = 0; s < ShowMe::MAX_STRINGS; ++s)
+        if (stringNoteCount[s] > 0)
+            out.addEvent (juce::MidiMessage::allNotesOff (s + 1), samplePosition);
+
+    std::memset (noteString, -1, sizeof (noteString));
+    std::fill (std::begin (stringNoteCount), std::end (stringNoteCount), 0);
 }
 
 bool AudioPluginAudioProcessor::hasEditor() const
@@ -148,12 +372,40 @@ juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor()
 
 void AudioPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    juce::ignoreUnused (destData);
+    juce::ValueTree state ("ShowMeMidi");
+    state.setProperty ("clipFile", lookaheadClip.getFile().getFullPathName(), nullptr);
+    state.setProperty ("lookaheadBeats", lookaheadBeats.load(), nullptr);
+    state.setProperty ("position", fretPosition.load(), nullptr);
+    state.setProperty ("range", fretRange.load(), nullptr);
+    state.setProperty ("strings", numStrings.load(), nullptr);
+    state.setProperty ("frets", numFrets.load(), nullptr);
+    state.setProperty ("channelPerString", channelPerString.load(), nullptr);
+    state.setProperty ("keyDetectMode", keyDetectMode.load(), nullptr);
+
+    if (auto xml = state.createXml())
+        copyXmlToBinary (*xml, destData);
 }
 
 void AudioPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    juce::ignoreUnused (data, sizeInBytes);
+    auto xml = getXmlFromBinary (data, sizeInBytes);
+    if (xml == nullptr)
+        return;
+
+    auto state = juce::ValueTree::fromXml (*xml);
+    lookaheadBeats.store ((int) state.getProperty ("lookaheadBeats", 4));
+    fretPosition.store ((int) state.getProperty ("position", 0));
+    fretRange.store ((int) state.getProperty ("range", 5));
+    numStrings.store ((int) state.getProperty ("strings", 6));
+    numFrets.store ((int) state.getProperty ("frets", 24));
+    channelPerString.store ((bool) state.getProperty ("channelPerString", false));
+    keyDetectMode.store ((int) state.getProperty ("keyDetectMode", (int) keyDetectSuggest));
+
+    juce::String clipPath = state.getProperty ("clipFile").toString();
+    if (clipPath.isNotEmpty() && juce::File::isAbsolutePath (clipPath))
+        lookaheadClip.loadFromFile (juce::File (clipPath));
+    else
+        lookaheadClip.clear();
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include <set>
-#include <mutex>
+#include "Fingering.h"
+#include "KeyDetector.h"
+#include "LookaheadClip.h"
+#include <atomic>
+#include <cstdint>
 
 class AudioPluginAudioProcessor  : public juce::AudioProcessor
 {
@@ -37,9 +40,75 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
     
-    std::set<int> activeNotes;
-    std::mutex notesMutex;
+    // Held notes as a 128-bit mask, ascending note order when iterated
+    struct NoteSnapshot
+    {
+        uint32_t bits[4] {};
+
+        bool isOn (int note) const          { return ((bits[note >> 5] >> (note & 31)) & 1u) != 0; }
+        bool isEmpty() const                { return (bits[0] | bits[1] | bits[2] | bits[3]) == 0; }
+        bool operator== (const NoteSnapshot& o) const
+        {
+            return bits[0] == o.bits[0] && bits[1] == o.bits[1] && bits[2] == o.bits[2] && bits[3] == o.bits[3];
+        }
+
+        template <typename Fn>
+        void forEachNote (Fn&& fn) const
+        {
+            for (int note = 0; note < 128; ++note)
+                if (isOn (note))
+                    fn (note);
+        }
+    };
+
+    // Lock-free read of the held notes; version changes whenever they do, so an
+    // unchanged version means nothing needs redrawing
+    NoteSnapshot getActiveNotes (uint32_t& version) const;
+    uint32_t getNoteStateVersion() const    { return noteStateVersion.load (std::memory_order_acquire); }
+
+    // Host transport, published from the audio thread for the lookahead display
+    std::atomic<double> hostPpq { 0.0 };
+    std::atomic<bool> hostHasPpq { false };
+    std::atomic<bool> hostIsPlaying { false };
+
+    // Fretboard settings, written by the editor and read by the audio thread
+    std::atomic<int> fretPosition { 0 };
+    std::atomic<int> fretRange { 5 };
+    std::atomic<int> numStrings { 6 };
+    std::atomic<int> numFrets { 24 };
+
+    // Rewrite outgoing notes to one MIDI channel per string (channel 1 = high E)
+    std::atomic<bool> channelPerString { false };
+
+    // Key/scale detection from incoming notes
+    enum KeyDetectMode { keyDetectOff = 0, keyDetectSuggest, keyDetectAutoApply };
+    std::atomic<int> keyDetectMode { keyDetectSuggest };
+    std::atomic<int> detectedKey { -1 };
+    std::atomic<int> detectedScale { -1 };
+
+    // Loaded MIDI clip for reading ahead - only touched on the message thread
+    LookaheadClip lookaheadClip;
+    std::atomic<int> lookaheadBeats { 4 };
 
 private:
+    // Written only by the audio thread; the version is bumped after the mask changes
+    std::atomic<uint32_t> noteBits[4] {};
+    std::atomic<uint32_t> noteStateVersion { 0 };
+    void updateActiveNotes (const juce::MidiBuffer& midiMessages);
+
+    // Channel-per-string output - audio thread only, fixed size so processBlock never allocates
+    void rewriteToStringChannels (juce::MidiBuffer& midiMessages);
+    void releaseStringChannels (juce::MidiBuffer& out, int samplePosition);
+    void updateKeyDetection (const juce::MidiBuffer& midiMessages, int numSamples);
+
+    ShowMe::Fingering outputFingering;
+    juce::MidiBuffer stringChannelMidi;
+    int8_t noteString[16][128];                   // string a sounding note went to, -1 if none
+    int stringNoteCount[ShowMe::MAX_STRINGS] {};
+    bool wasRewriting = false;
+
+    // Audio thread only
+    KeyDetector keyDetector;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessor)
 };
@@ -0,0 +1,53 @@
+#pragma once
+
+// Note and scale tables shared by the Show Me MIDI plugin and tools
+namespace ShowMe
+{
+    constexpr const char* NOTE_NAMES[12] = { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
+
+    constexpr const char* SCALE_NAMES[] = {
+        "Chromatic", "Major", "Minor", "Harmonic Minor", "Melodic Minor",
+        "Pentatonic Maj", "Pentatonic Min", "Blues", "Dorian", "Phrygian",
+        "Lydian", "Mixolydian", "Locrian", "Whole Tone", "Diminished",
+        "Phrygian Dominant", "Hungarian Minor", "Double Harmonic"
+    };
+    constexpr int NUM_SCALES = 18;
+
+    constexpr int SCALE_PATTERNS[NUM_SCALES][12] = {
+        { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+        { 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1 },
+        { 1, 0, 1, 1, 0, 1, 0, 1, 1, 0, 1, 0 },
+        { 1, 0, 1, 1, 0, 1, 0, 1, 1, 0, 0, 1 },
+        { 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0, 1 },
+        { 1, 0, 1, 0, 1, 0, 0, 1, 0, 1, 0, 0 },
+        { 1, 0, 0, 1, 0, 1, 0, 1, 0, 0, 1, 0 },
+        { 1, 0, 0, 1, 0, 1, 1, 1, 0, 0, 1, 0 },
+        { 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 1, 0 },
+        { 1, 1, 0, 1, 0, 1, 0, 1, 1, 0, 1, 0 },
+        { 1, 0, 1, 0, 1, 0, 1, 1, 0, 1, 0, 1 },
+        { 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 1, 0 },
+        { 1, 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0 },
+        { 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0 },
+        { 1, 0, 1, 1, 0, 1, 1, 0, 1, 1, 0, 1 },
+        { 1, 1, 0, 0, 1, 1, 0, 1, 1, 0, 1, 0 },
+        { 1, 0, 1, 1, 0, 0, 1, 1, 1, 0, 0, 1 },
+        { 1, 1, 0, 0, 1, 1, 0, 1, 1, 0, 0, 1 },
+    };
+
+    // Pitch classes of a scale as a 12-bit mask, bit 0 = root
+    constexpr unsigned scaleMask (int scaleIndex)
+    {
+        unsigned mask = 0;
+        for (int i = 0; i < 12; ++i)
+            if (SCALE_PATTERNS[scaleIndex][i] == 1)
+                mask |= 1u << i;
+        return mask;
+    }
+
+    // Rotates a 12-bit pitch-class mask up by semitones, e.g. moves a scale to a new key
+    constexpr unsigned rotateMask (unsigned mask, int semitones)
+    {
+        semitones = ((semitones % 12) + 12) % 12;
+        return ((mask << semitones) | (mask >> (12 - semitones))) & 0xfffu;
+    }
+}
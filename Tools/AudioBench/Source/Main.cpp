@@ -0,0 +1,302 @@
+// AudioBench - headless harness for the Show Me Audio analyser.
+// Builds the plugin's processor directly, puts it in offline (non-realtime) mode and feeds it
+// synthetic plucked-string audio or a sound file, so analysis runs on its fixed sample hop and
+// every run over the same input produces the same frames and MIDI.
+
+#include <JuceHeader.h>
+#include "../../../Audio/Source/PluginProcessor.h"
+#include "../../../Audio/Source/DifferenceKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Options
+    {
+        juce::String command;
+        juce::File input;
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        double seconds = 60.0;
+        int repeats = 3;
+        bool bassMode = false;
+        int maxThreads = 8;
+    };
+
+    struct MidiEvent
+    {
+        juce::int64 samplePosition;
+        juce::uint8 bytes[3];
+
+        bool operator== (const MidiEvent& o) const
+        {
+            return samplePosition == o.samplePosition && std::equal (bytes, bytes + 3, o.bytes);
+        }
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: AudioBench <command> [options]\n"
+                     "Commands:\n"
+                     "  throughput        offline analysis speed (realtime factor, frames/s)\n"
+                     "  determinism       renders at several block sizes and compares the MIDI output\n"
+                     "  scaling           YIN difference function time for 1..N threads, checked against serial\n"
+                     "Options:\n"
+                     "  --input <file>    analyse a sound file instead of the synthetic test signal\n"
+                     "  --rate <hz>       sample rate of the synthetic signal (default 48000)\n"
+                     "  --block <n>       block size (default 512)\n"
+                     "  --seconds <n>     length of the synthetic signal (default 60)\n"
+                     "  --repeats <n>     throughput runs, best is reported (default 3)\n"
+                     "  --bass            analyse with the long bass-mode window\n"
+                     "  --threads <n>     most threads for scaling (default 8)\n";
+    }
+
+    // Karplus-Strong plucks walking up and down the open strings and a few fretted notes,
+    // with rests between some of them so the segmenter sees both legato and detached notes
+    juce::AudioBuffer<float> makePluckedSignal (double sampleRate, double seconds)
+    {
+        static const int melody[] = { 40, 45, 50, 55, 59, 64, 67, 64, 59, 55, 52, 47, 43, 45, 48, 52 };
+        const int numSamples = (int) (sampleRate * seconds);
+        const int noteLength = (int) (sampleRate * 0.4);
+
+        juce::AudioBuffer<float> signal (1, numSamples);
+        signal.clear();
+        auto* out = signal.getWritePointer (0);
+
+        juce::Random random (1234);     // Fixed seed: the same signal every run
+        std::vector<float> line;
+
+        for (int start = 0, n = 0; start < numSamples; start += noteLength, ++n)
+        {
+            const int midiNote = melody[n % (int) std::size (melody)];
+            const double hz = 440.0 * std::pow (2.0, (midiNote - 69) / 12.0);
+            const int period = juce::jmax (2, (int) std::round (sampleRate / hz));
+
+            line.resize ((size_t) period);
+            for (auto& s : line)
+                s = random.nextFloat() * 2.0f - 1.0f;
+
+            // Every fourth note is cut short to leave a gap
+            const int length = juce::jmin (numSamples - start, (n % 4 == 3) ? noteLength / 2 : noteLength);
+            for (int i = 0; i < length; ++i)
+            {
+                const size_t k = (size_t) (i % period);
+                const float next = line[(k + 1) % (size_t) period];
+                const float sample = line[k];
+                line[k] = 0.996f * 0.5f * (sample + next);
+                out[start + i] = 0.5f * sample;
+            }
+        }
+
+        return signal;
+    }
+
+    bool loadInput (const juce::File& file, juce::AudioBuffer<float>& signal, double& sampleRate)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (file));
+        if (reader == nullptr)
+            return false;
+
+        signal.setSize ((int) reader->numChannels, (int) reader->lengthInSamples);
+        reader->read (&signal, 0, (int) reader->lengthInSamples, 0, true, true);
+        sampleRate = reader->sampleRate;
+        return true;
+    }
+
+    // Runs the whole signal through a fresh processor in offline mode; returns MIDI with absolute positions
+    std::vector<MidiEvent> render (const juce::AudioBuffer<float>& signal, double sampleRate, int blockSize, bool bassMode, double& elapsedSeconds)
+    {
+        AudioPluginAudioProcessor processor;
+        processor.bassMode = bassMode;
+        processor.setNonRealtime (true);
+        processor.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<float> block (2, blockSize);
+        juce::MidiBuffer midi;
+        std::vector<MidiEvent> events;
+
+        const int numSamples = signal.getNumSamples();
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int pos = 0; pos < numSamples; pos += blockSize)
+        {
+            const int n = juce::jmin (blockSize, numSamples - pos);
+            block.setSize (2, n, false, false, true);
+            for (int ch = 0; ch < 2; ++ch)
+                block.copyFrom (ch, 0, signal, juce::jmin (ch, signal.getNumChannels() - 1), pos, n);
+
+            midi.clear();
+            processor.processBlock (block, midi);
+
+            for (const auto metadata : midi)
+            {
+                MidiEvent e { pos + metadata.samplePosition, { 0, 0, 0 } };
+                std::copy (metadata.data, metadata.data + juce::jmin (3, metadata.numBytes), e.bytes);
+                events.push_back (e);
+            }
+        }
+
+        elapsedSeconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+        processor.releaseResources();
+        return events;
+    }
+
+    int countNoteOns (const std::vector<MidiEvent>& events)
+    {
+        return (int) std::count_if (events.begin(), events.end(), [] (const MidiEvent& e) { return (e.bytes[0] & 0xf0) == 0x90 && e.bytes[2] > 0; });
+    }
+
+    int runThroughput (const juce::AudioBuffer<float>& signal, double sampleRate, const Options& options)
+    {
+        const double audioSeconds = signal.getNumSamples() / sampleRate;
+        const int frames = signal.getNumSamples() / juce::roundToInt (sampleRate / 50.0);
+
+        double best = 1.0e30;
+        std::vector<MidiEvent> events;
+        for (int r = 0; r < options.repeats; ++r)
+        {
+            double elapsed = 0.0;
+            events = render (signal, sampleRate, options.blockSize, options.bassMode, elapsed);
+            best = juce::jmin (best, juce::jmax (elapsed, 1.0e-9));
+        }
+
+        std::cout << "Rendered " << juce::String (audioSeconds, 1) << " s at " << sampleRate << " Hz, block "
+                  << options.blockSize << ", best of " << options.repeats << ": " << juce::String (best, 3) << " s\n";
+        std::cout << "Throughput: " << juce::String (audioSeconds / best, 1) << "x realtime, "
+                  << juce::String (frames / best, 0) << " frames/s, "
+                  << juce::String (best * 1.0e6 / juce::jmax (1, frames), 1) << " us/frame, "
+                  << countNoteOns (events) << " notes\n";
+        return 0;
+    }
+
+    int runDeterminism (const juce::AudioBuffer<float>& signal, double sampleRate, const Options& options)
+    {
+        // Includes sizes that do not divide the analysis hop
+        const int blockSizes[] = { 64, 441, 512, 1000, 4096 };
+        std::vector<MidiEvent> reference;
+        bool identical = true;
+
+        for (int blockSize : blockSizes)
+        {
+            double elapsed = 0.0;
+            auto events = render (signal, sampleRate, blockSize, options.bassMode, elapsed);
+            std::cout << "block " << blockSize << ": " << events.size() << " MIDI events, " << countNoteOns (events) << " notes\n";
+
+            if (reference.empty())
+                reference = std::move (events);
+            else if (events != reference)
+                identical = false;
+        }
+
+        std::cout << (identical ? "MIDI output identical for all block sizes\n" : "MIDI output DIFFERS between block sizes\n");
+        return identical ? 0 : 2;
+    }
+
+    int runScaling (const juce::AudioBuffer<float>& signal, const Options& options)
+    {
+        std::cout << "Difference function, ms per window (speedup over 1 thread), "
+                  << std::thread::hardware_concurrency() << " hardware threads\n";
+
+        bool identical = true;
+        for (int halfSize : { 2048, 4096, 8192 })
+        {
+            // Any stretch of the test signal will do; pad with silence if it is short
+            std::vector<float> window ((size_t) halfSize * 2, 0.0f);
+            const int n = juce::jmin ((int) window.size(), signal.getNumSamples());
+            std::copy (signal.getReadPointer (0), signal.getReadPointer (0) + n, window.begin());
+
+            std::vector<float> reference ((size_t) halfSize), result ((size_t) halfSize);
+            DifferenceKernel::computeRange (window.data(), halfSize, 1, halfSize, reference.data());
+
+            std::cout << "window " << halfSize * 2 << ":";
+            double serialMs = 0.0;
+            for (int threads = 1; threads <= options.maxThreads; ++threads)
+            {
+                DifferenceKernel kernel (threads - 1);
+                kernel.compute (window.data(), halfSize, result.data(), true);   // Warm up the workers
+
+                double best = 1.0e30;
+                for (int r = 0; r < options.repeats; ++r)
+                {
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    kernel.compute (window.data(), halfSize, result.data(), true);
+                    best = juce::jmin (best, juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start) * 1000.0);
+                }
+
+                if (threads == 1)
+                    serialMs = best;
+                if (! std::equal (reference.begin() + 1, reference.end(), result.begin() + 1))
+                    identical = false;
+
+                std::cout << "  " << threads << ": " << juce::String (best, 2) << " (" << juce::String (serialMs / best, 2) << "x)";
+            }
+            std::cout << "\n";
+        }
+
+        std::cout << (identical ? "All results bit-identical to the serial loop\n" : "Results DIFFER from the serial loop\n");
+        return identical ? 0 : 2;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg (argv[i]);
+        auto nextDouble = [&] (double& value, double lo, double hi)
+        {
+            if (i + 1 < argc)
+                value = juce::jlimit (lo, hi, juce::String (argv[++i]).getDoubleValue());
+        };
+        auto nextInt = [&] (int& value, int lo, int hi)
+        {
+            if (i + 1 < argc)
+                value = juce::jlimit (lo, hi, juce::String (argv[++i]).getIntValue());
+        };
+
+        if (arg == "-h" || arg == "--help")          { printUsage(); return 0; }
+        else if (arg == "--input" && i + 1 < argc)   options.input = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+        else if (arg == "--rate")                    nextDouble (options.sampleRate, 8000.0, 384000.0);
+        else if (arg == "--block")                   nextInt (options.blockSize, 1, 65536);
+        else if (arg == "--seconds")                 nextDouble (options.seconds, 1.0, 36000.0);
+        else if (arg == "--repeats")                 nextInt (options.repeats, 1, 100);
+        else if (arg == "--bass")                    options.bassMode = true;
+        else if (arg == "--threads")                 nextInt (options.maxThreads, 1, 64);
+        else if (options.command.isEmpty())          options.command = arg;
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    juce::AudioBuffer<float> signal;
+    double sampleRate = options.sampleRate;
+    if (options.input != juce::File())
+    {
+        if (! loadInput (options.input, signal, sampleRate))
+        {
+            std::cerr << "Cannot read " << options.input.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+    else
+    {
+        signal = makePluckedSignal (sampleRate, options.seconds);
+    }
+
+    if (options.command == "throughput")     return runThroughput (signal, sampleRate, options);
+    if (options.command == "determinism")    return runDeterminism (signal, sampleRate, options);
+    if (options.command == "scaling")        return runScaling (signal, options);
+
+    printUsage();
+    return 1;
+}
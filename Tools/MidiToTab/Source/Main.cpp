@@ -0,0 +1,397 @@
+// MidiToTab - headless batch converter from .mid files to guitar tablature.
+// Runs the same fingering logic as the Show Me MIDI plugin and writes, per input file,
+// an ASCII tab (.tab.txt) and a JSON list of string/fret events (.tab.json).
+// Each file is converted independently with a fresh hand position, so the output
+// does not depend on thread count or scheduling.
+
+#include <JuceHeader.h>
+#include "../../../Source/Fingering.h"
+#include "../../../Source/Scales.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+namespace {
+    using ShowMe::NOTE_NAMES;
+    const int DRUM_CHANNEL = 10;
+
+    struct Options
+    {
+        juce::File outputDir;
+        int threads = juce::SystemStats::getNumCpus();
+        int position = 0;
+        int range = 5;
+        int strings = 6;
+        int frets = 24;
+        int lineWidth = 80;
+        bool includeDrums = false;
+    };
+
+    struct TabEvent
+    {
+        int tick;
+        double time;
+        double duration;
+        int midiNote;
+        int velocity;
+        int channel;
+        ShowMe::NotePosition pos;
+    };
+
+    struct FileResult
+    {
+        juce::File input;
+        bool ok = false;
+        juce::String error;
+        int numNotes = 0;
+        int numUnplayable = 0;
+        juce::int64 inputBytes = 0;
+    };
+
+    // Collects every note-on from all tracks, ordered by tick, then pitch, channel and track
+    bool readNotes (const juce::File& file, std::vector<TabEvent>& notes, const Options& options, juce::String& error)
+    {
+        juce::FileInputStream stream (file);
+        if (! stream.openedOk())
+        {
+            error = "cannot open file";
+            return false;
+        }
+
+        juce::MidiFile midi;
+        if (! midi.readFrom (stream))
+        {
+            error = "not a valid MIDI file";
+            return false;
+        }
+
+        // Keep a tick-based copy; the seconds copy has identical event indices
+        juce::MidiFile timed (midi);
+        timed.convertTimestampTicksToSeconds();
+
+        struct Keyed { TabEvent e; int track; };
+        std::vector<Keyed> keyed;
+
+        for (int t = 0; t < midi.getNumTracks(); ++t)
+        {
+            juce::MidiMessageSequence ticks (*midi.getTrack (t));
+            juce::MidiMessageSequence seconds (*timed.getTrack (t));
+            ticks.updateMatchedPairs();
+            seconds.updateMatchedPairs();
+
+            for (int i = 0; i < ticks.getNumEvents(); ++i)
+            {
+                const auto& msg = ticks.getEventPointer (i)->message;
+                if (! msg.isNoteOn())
+                    continue;
+                if (msg.getChannel() == DRUM_CHANNEL && ! options.includeDrums)
+                    continue;
+
+                double start = seconds.getEventTime (i);
+                double end = seconds.getTimeOfMatchingKeyUp (i);
+
+                TabEvent e;
+                e.tick = (int) msg.getTimeStamp();
+                e.time = start;
+                e.duration = end > start ? end - start : 0.0;
+                e.midiNote = msg.getNoteNumber();
+                e.velocity = msg.getVelocity();
+                e.channel = msg.getChannel();
+                e.pos = { -1, -1, e.midiNote };
+                keyed.push_back ({ e, t });
+            }
+        }
+
+        std::sort (keyed.begin(), keyed.end(), [] (const Keyed& a, const Keyed& b)
+        {
+            if (a.e.tick != b.e.tick) return a.e.tick < b.e.tick;
+            if (a.e.midiNote != b.e.midiNote) return a.e.midiNote < b.e.midiNote;
+            if (a.e.channel != b.e.channel) return a.e.channel < b.e.channel;
+            return a.track < b.track;
+        });
+
+        notes.clear();
+        notes.reserve (keyed.size());
+        for (auto& k : keyed)
+            notes.push_back (k.e);
+
+        return true;
+    }
+
+    // Fingers notes chord by chord: notes starting on the same tick avoid each other's strings,
+    // and the hand follows the lowest note of each chord like the plugin does
+    int assignPositions (std::vector<TabEvent>& notes, const Options& options)
+    {
+        ShowMe::Fingering fingering;
+        int unplayable = 0;
+
+        for (size_t i = 0; i < notes.size();)
+        {
+            size_t end = i;
+            while (end < notes.size() && notes[end].tick == notes[i].tick)
+                ++end;
+
+            unsigned usedStrings = 0;
+            bool movedHand = false;
+            for (size_t n = i; n < end; ++n)
+            {
+                auto pos = fingering.findOptimalPosition (notes[n].midiNote, options.position, options.range,
+                                                          options.strings, options.frets, usedStrings);
+                notes[n].pos = pos;
+
+                if (pos.stringIndex < 0)
+                {
+                    ++unplayable;
+                    continue;
+                }
+
+                usedStrings |= 1u << pos.stringIndex;
+                if (! movedHand)
+                {
+                    fingering.moveTo (pos);
+                    movedHand = true;
+                }
+            }
+
+            i = end;
+        }
+
+        return unplayable;
+    }
+
+    juce::String stringLabel (int stringIndex)
+    {
+        juce::String name (NOTE_NAMES[ShowMe::GUITAR_TUNING[stringIndex] % 12]);
+        // Traditional lowercase for the high E string
+        if (stringIndex == 0)
+            name = name.toLowerCase();
+        return name.paddedRight (' ', 2);
+    }
+
+    juce::String buildAsciiTab (const std::vector<TabEvent>& notes, const Options& options)
+    {
+        const int numStrings = options.strings;
+        juce::String current[ShowMe::MAX_STRINGS];
+        juce::String result;
+
+        auto flush = [&]
+        {
+            if (current[0].isEmpty())
+                return;
+            for (int s = 0; s < numStrings; ++s)
+                result << stringLabel (s) << "|" << current[s] << "|\n";
+            result << "\n";
+            for (int s = 0; s < numStrings; ++s)
+                current[s].clear();
+        };
+
+        for (size_t i = 0; i < notes.size();)
+        {
+            size_t end = i;
+            juce::String column[ShowMe::MAX_STRINGS];
+            int width = 1;
+
+            while (end < notes.size() && notes[end].tick == notes[i].tick)
+            {
+                const auto& pos = notes[end].pos;
+                if (pos.stringIndex >= 0 && column[pos.stringIndex].isEmpty())
+                {
+                    column[pos.stringIndex] = juce::String (pos.fret);
+                    width = juce::jmax (width, column[pos.stringIndex].length());
+                }
+                ++end;
+            }
+
+            if (current[0].length() + width + 1 > options.lineWidth)
+                flush();
+
+            for (int s = 0; s < numStrings; ++s)
+                current[s] << "-" << column[s].paddedRight ('-', width);
+
+            i = end;
+        }
+
+        flush();
+        return result;
+    }
+
+    juce::String buildJson (const juce::File& input, const std::vector<TabEvent>& notes, const Options& options)
+    {
+        juce::String json;
+        json << "{\n";
+        json << "  \"file\": " << juce::JSON::toString (input.getFileName()) << ",\n";
+        json << "  \"strings\": " << options.strings << ",\n";
+        json << "  \"frets\": " << options.frets << ",\n";
+        json << "  \"position\": " << options.position << ",\n";
+        json << "  \"range\": " << options.range << ",\n";
+        json << "  \"events\": [";
+
+        for (size_t i = 0; i < notes.size(); ++i)
+        {
+            const auto& e = notes[i];
+            json << (i == 0 ? "\n" : ",\n");
+            json << "    { \"tick\": " << e.tick
+                 << ", \"time\": " << juce::String (e.time, 6)
+                 << ", \"duration\": " << juce::String (e.duration, 6)
+                 << ", \"note\": " << e.midiNote
+                 << ", \"velocity\": " << e.velocity
+                 << ", \"channel\": " << e.channel
+                 << ", \"string\": " << (e.pos.stringIndex >= 0 ? e.pos.stringIndex + 1 : -1)
+                 << ", \"fret\": " << e.pos.fret << " }";
+        }
+
+        json << (notes.empty() ? "]\n" : "\n  ]\n");
+        json << "}\n";
+        return json;
+    }
+
+    bool writeText (const juce::File& file, const juce::String& text)
+    {
+        file.deleteFile();
+        juce::FileOutputStream out (file);
+        if (! out.openedOk())
+            return false;
+        out.writeText (text, false, false, "\n");
+        return true;
+    }
+
+    FileResult convertFile (const juce::File& input, const Options& options)
+    {
+        FileResult result;
+        result.input = input;
+        result.inputBytes = input.getSize();
+
+        std::vector<TabEvent> notes;
+        if (! readNotes (input, notes, options, result.error))
+            return result;
+
+        result.numNotes = (int) notes.size();
+        result.numUnplayable = assignPositions (notes, options);
+
+        auto dir = options.outputDir.exists() ? options.outputDir : input.getParentDirectory();
+        auto base = input.getFileNameWithoutExtension();
+
+        if (! writeText (dir.getChildFile (base + ".tab.txt"), buildAsciiTab (notes, options))
+         || ! writeText (dir.getChildFile (base + ".tab.json"), buildJson (input, notes, options)))
+        {
+            result.error = "cannot write output";
+            return result;
+        }
+
+        result.ok = true;
+        return result;
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: MidiToTab [options] <file.mid | folder>...\n"
+                     "  -o <folder>       output folder (default: next to each input)\n"
+                     "  -j <n>            worker threads (default: all cores)\n"
+                     "  --position <n>    preferred fret position (default 0)\n"
+                     "  --range <n>       finger range in frets (default 5)\n"
+                     "  --strings <n>     number of strings, 4-8 (default 6)\n"
+                     "  --frets <n>       number of frets, 12-24 (default 24)\n"
+                     "  --width <n>       tab line width (default 80)\n"
+                     "  --include-drums   also convert channel 10\n";
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    Options options;
+    juce::Array<juce::File> inputs;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg (argv[i]);
+        auto nextInt = [&] (int& value, int lo, int hi)
+        {
+            if (i + 1 < argc)
+                value = juce::jlimit (lo, hi, juce::String (argv[++i]).getIntValue());
+        };
+
+        if (arg == "-h" || arg == "--help")          { printUsage(); return 0; }
+        else if (arg == "-o" && i + 1 < argc)        options.outputDir = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+        else if (arg == "-j")                        nextInt (options.threads, 1, 256);
+        else if (arg == "--position")                nextInt (options.position, 0, 24);
+        else if (arg == "--range")                   nextInt (options.range, 1, 12);
+        else if (arg == "--strings")                 nextInt (options.strings, 4, ShowMe::MAX_STRINGS);
+        else if (arg == "--frets")                   nextInt (options.frets, 12, 24);
+        else if (arg == "--width")                   nextInt (options.lineWidth, 20, 1000);
+        else if (arg == "--include-drums")           options.includeDrums = true;
+        else
+        {
+            auto f = juce::File::getCurrentWorkingDirectory().getChildFile (arg);
+            if (f.isDirectory())
+            {
+                for (const auto& entry : juce::RangedDirectoryIterator (f, true, "*.mid;*.midi"))
+                    inputs.add (entry.getFile());
+            }
+            else if (f.existsAsFile())
+            {
+                inputs.add (f);
+            }
+            else
+            {
+                std::cerr << "Skipping missing input: " << arg << "\n";
+            }
+        }
+    }
+
+    if (inputs.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    // Sorted so the summary and any shared output folder are identical between runs
+    inputs.sort();
+    if (options.outputDir != juce::File())
+        options.outputDir.createDirectory();
+
+    std::vector<FileResult> results ((size_t) inputs.size());
+    std::atomic<int> remaining { inputs.size() };
+    juce::WaitableEvent allDone;
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    {
+        juce::ThreadPool pool (juce::jmin (options.threads, inputs.size()));
+        for (int i = 0; i < inputs.size(); ++i)
+        {
+            pool.addJob ([&, i]
+            {
+                results[(size_t) i] = convertFile (inputs[i], options);
+                if (--remaining == 0)
+                    allDone.signal();
+            });
+        }
+        allDone.wait();
+    }
+    double seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+    int failed = 0;
+    juce::int64 totalNotes = 0, totalUnplayable = 0, totalBytes = 0;
+    for (const auto& r : results)
+    {
+        if (! r.ok)
+        {
+            ++failed;
+            std::cerr << "FAILED " << r.input.getFullPathName() << ": " << r.error << "\n";
+            continue;
+        }
+        totalNotes += r.numNotes;
+        totalUnplayable += r.numUnplayable;
+        totalBytes += r.inputBytes;
+    }
+
+    seconds = juce::jmax (seconds, 1.0e-9);
+    std::cout << "Converted " << (inputs.size() - failed) << "/" << inputs.size() << " files, "
+              << totalNotes << " notes (" << totalUnplayable << " out of range) in "
+              << juce::String (seconds, 3) << " s on " << juce::jmin (options.threads, inputs.size()) << " threads\n";
+    std::cout << "Throughput: " << juce::String (inputs.size() / seconds, 1) << " files/s, "
+              << juce::String (totalNotes / seconds, 0) << " notes/s, "
+              << juce::String (totalBytes / seconds / (1024.0 * 1024.0), 2) << " MB/s\n";
+
+    return failed == 0 ? 0 : 2;
+}